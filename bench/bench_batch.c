@@ -0,0 +1,141 @@
+#define _POSIX_C_SOURCE 199309L
+#include "batch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_util.h"
+
+/* Batched simulator throughput. First checks that BatchSim produces the
+ * same games as core_step(), then reports game-ticks/sec as N grows,
+ * next to the same workload on an array of GameLogic. */
+
+#define CHECK_GAMES 64
+#define CHECK_TICKS 20000
+#define GAME_TICKS_PER_RUN 20000000u
+
+// Scripted bot input: a new random direction for every game each 32 ticks.
+static void fill_inputs(uint8_t *inputs, uint32_t count, uint32_t tick) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t h = bench_script_hash(i + 1, tick >> 5);
+        inputs[i] = (h & 7) < 4 ? (uint8_t)(h & 3) : DIR_COUNT;
+    }
+}
+
+static void resume_game(GameLogic *game, uint32_t seed) {
+    if (game->state == STATE_GAME_OVER || game->state == STATE_GAME_COMPLETE) core_init(game, seed);
+    while (game->state == STATE_LIFE_LOST || game->state == STATE_START_LEVEL) core_resume(game);
+}
+
+static bool same_game(const GameLogic *a, const GameLogic *b) {
+    const GameEntity *pa = &a->player.pacman, *pb = &b->player.pacman;
+    if (memcmp(a->map, b->map, sizeof(a->map)) != 0 || memcmp(a->dots, b->dots, sizeof(a->dots)) != 0) return false;
+    if (pa->row != pb->row || pa->col != pb->col || pa->dir != pb->dir || pa->moveTimer != pb->moveTimer) return false;
+    if (a->player.score != b->player.score || a->player.hunterTime != b->player.hunterTime ||
+        a->player.lives != b->player.lives || a->player.dotsEaten != b->player.dotsEaten ||
+        a->player.rewardCount != b->player.rewardCount || a->player.ghostCombo != b->player.ghostCombo) return false;
+    for (int g = 0; g < 4; g++) {
+        const GameEntity *ga = &a->ghosts[g], *gb = &b->ghosts[g];
+        if (ga->row != gb->row || ga->col != gb->col || ga->dir != gb->dir ||
+            ga->moveTimer != gb->moveTimer || ga->scared != gb->scared) return false;
+    }
+    return a->state == b->state && a->events == b->events && a->rng == b->rng;
+}
+
+static bool check_equivalence(void) {
+    BatchSim sim;
+    GameLogic games[CHECK_GAMES], view;
+    uint8_t inputs[CHECK_GAMES];
+
+    if (!batch_init(&sim, CHECK_GAMES, 1, true)) return false;
+    for (uint32_t i = 0; i < CHECK_GAMES; i++) {
+        core_init(&games[i], 1 + i);
+        resume_game(&games[i], 1 + i);
+    }
+
+    for (uint32_t t = 0; t < CHECK_TICKS; t++) {
+        fill_inputs(inputs, CHECK_GAMES, t);
+        batch_step(&sim, inputs);
+        for (uint32_t i = 0; i < CHECK_GAMES; i++) {
+            core_step(&games[i], inputs[i]);
+            resume_game(&games[i], 1 + i);
+            if (sim.state[i] == STATE_GAME_OVER || sim.state[i] == STATE_GAME_COMPLETE) batch_init_game(&sim, i, 1 + i);
+
+            batch_get_game(&sim, i, &view);
+            if (!same_game(&games[i], &view)) {
+                fprintf(stderr, "mismatch: game %u at tick %u\n", i, t);
+                batch_free(&sim);
+                return false;
+            }
+        }
+    }
+    batch_free(&sim);
+    return true;
+}
+
+static double run_batch(uint32_t count, uint32_t ticks, uint8_t *inputs) {
+    BatchSim sim;
+    if (!batch_init(&sim, count, 1, true)) return 0;
+
+    double start = bench_now_sec();
+    for (uint32_t t = 0; t < ticks; t++) {
+        if ((t & 31) == 0) fill_inputs(inputs, count, t);
+        batch_step(&sim, inputs);
+        for (uint32_t i = 0; i < count; i++) {
+            if (sim.state[i] == STATE_GAME_OVER || sim.state[i] == STATE_GAME_COMPLETE) batch_init_game(&sim, i, 1 + i);
+        }
+    }
+    double elapsed = bench_now_sec() - start;
+    batch_free(&sim);
+    return (double)count * ticks / elapsed;
+}
+
+static double run_core(uint32_t count, uint32_t ticks, uint8_t *inputs) {
+    GameLogic *games = malloc(sizeof(GameLogic) * count);
+    if (!games) return 0;
+    for (uint32_t i = 0; i < count; i++) {
+        core_init(&games[i], 1 + i);
+        resume_game(&games[i], 1 + i);
+    }
+
+    double start = bench_now_sec();
+    for (uint32_t t = 0; t < ticks; t++) {
+        if ((t & 31) == 0) fill_inputs(inputs, count, t);
+        for (uint32_t i = 0; i < count; i++) {
+            core_step(&games[i], inputs[i]);
+            resume_game(&games[i], 1 + i);
+        }
+    }
+    double elapsed = bench_now_sec() - start;
+    free(games);
+    return (double)count * ticks / elapsed;
+}
+
+int main(void) {
+    if (!check_equivalence()) {
+        fprintf(stderr, "bench_batch: BatchSim diverged from core_step()\n");
+        return EXIT_FAILURE;
+    }
+    printf("equivalence: %d games x %d ticks match core_step()\n\n", CHECK_GAMES, CHECK_TICKS);
+
+    const uint32_t sizes[] = {1, 16, 256, 4096, 65536};
+    uint8_t *inputs = malloc(sizes[4]);
+    if (!inputs) return EXIT_FAILURE;
+
+    BatchSim probe;
+    if (batch_init(&probe, sizes[4], 1, true)) {
+        printf("state per game: batch %.1f bytes, GameLogic %zu bytes\n\n",
+               (double)((probe.moved + probe.count) - (uint8_t *)probe.pacRow) / probe.count, sizeof(GameLogic));
+        batch_free(&probe);
+    }
+
+    printf("%8s %18s %18s %8s\n", "games", "batch ticks/s", "GameLogic ticks/s", "speedup");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint32_t ticks = GAME_TICKS_PER_RUN / sizes[s];
+        double batch = run_batch(sizes[s], ticks, inputs);
+        double core = run_core(sizes[s], ticks, inputs);
+        printf("%8u %18.0f %18.0f %7.2fx\n", sizes[s], batch, core, core > 0 ? batch / core : 0);
+    }
+
+    free(inputs);
+    return EXIT_SUCCESS;
+}
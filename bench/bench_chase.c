@@ -0,0 +1,129 @@
+#define _POSIX_C_SOURCE 199309L
+#include "core.h"
+#include "rules.h"
+#include "chase4.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_util.h"
+
+/* The four-ghost chase kernel against rules_chase_dir(). First checks both
+ * kernels against the scalar rule on random ghost sets, then reports
+ * the cost of one four-ghost decision and of a whole core_step(). */
+
+#define SETS 65536
+#define CHECK_ROUNDS 64
+#define TIME_ROUNDS 200
+#define GAMES 64
+#define GAME_TICKS 100000u
+
+typedef struct {
+  int8_t row[4], col[4], targetRow[4], targetCol[4];
+  Direction dir[4];
+} GhostSet;
+
+// Any tile, walls included (ghosts start inside the house), targets as wide as Inky's.
+static void fill_sets(GhostSet *sets, uint32_t seed) {
+    uint32_t rng = seed;
+    for (int i = 0; i < SETS; i++) {
+        for (int g = 0; g < 4; g++) {
+            sets[i].row[g] = rules_rand(&rng) % MAP_ROWS;
+            sets[i].col[g] = rules_rand(&rng) % MAP_COLS;
+            sets[i].dir[g] = rules_rand(&rng) % DIR_COUNT;
+            sets[i].targetRow[g] = (int8_t)(rules_rand(&rng) % 96) - 32;
+            sets[i].targetCol[g] = (int8_t)(rules_rand(&rng) % 96) - 32;
+        }
+    }
+}
+
+static bool check_equivalence(const GhostSet *sets) {
+    const Maze *maze = maze_default();
+    for (int i = 0; i < SETS; i++) {
+        const GhostSet *s = &sets[i];
+        Direction simd[4], scalar[4];
+        chase4_dirs(maze, s->row, s->col, s->dir, s->targetRow, s->targetCol, simd);
+        chase4_dirs_scalar(maze, s->row, s->col, s->dir, s->targetRow, s->targetCol, scalar);
+
+        for (int g = 0; g < 4; g++) {
+            Direction ref = rules_chase_dir(maze, s->row[g], s->col[g], s->dir[g], s->targetRow[g], s->targetCol[g]);
+            if (simd[g] != ref || scalar[g] != ref) {
+                fprintf(stderr, "mismatch: set %d ghost %d: rule %d, %s %d, scalar %d\n",
+                        i, g, ref, chase4_isa(), simd[g], scalar[g]);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 0: rules_chase_dir() per ghost, 1: chase4_dirs_scalar(), 2: chase4_dirs()
+static double time_sets(const GhostSet *sets, int kernel, uint32_t *checksum) {
+    const Maze *maze = maze_default();
+    uint32_t sum = 0;
+
+    double start = bench_now_sec();
+    for (int round = 0; round < TIME_ROUNDS; round++) {
+        for (int i = 0; i < SETS; i++) {
+            const GhostSet *s = &sets[i];
+            Direction out[4];
+            if (kernel == 0) {
+                for (int g = 0; g < 4; g++) out[g] = rules_chase_dir(maze, s->row[g], s->col[g], s->dir[g], s->targetRow[g], s->targetCol[g]);
+            } else if (kernel == 1) {
+                chase4_dirs_scalar(maze, s->row, s->col, s->dir, s->targetRow, s->targetCol, out);
+            } else {
+                chase4_dirs(maze, s->row, s->col, s->dir, s->targetRow, s->targetCol, out);
+            }
+            sum += out[0] + out[1] * 4 + out[2] * 16 + out[3] * 64;
+        }
+    }
+    double elapsed = bench_now_sec() - start;
+    *checksum = sum;
+    return elapsed * 1e9 / ((double)SETS * TIME_ROUNDS);
+}
+
+static double time_ticks(void) {
+    static GameLogic games[GAMES];
+    for (uint32_t i = 0; i < GAMES; i++) {
+        core_init(&games[i], 1 + i);
+        core_resume(&games[i]);
+    }
+
+    double start = bench_now_sec();
+    for (uint32_t t = 0; t < GAME_TICKS; t++) {
+        for (uint32_t i = 0; i < GAMES; i++) {
+            GameLogic *game = &games[i];
+            uint32_t h = bench_script_hash(i + 1, t >> 5);
+            core_step(game, (Direction)(h & 3));
+
+            if (game->state == STATE_GAME_OVER || game->state == STATE_GAME_COMPLETE) core_init(game, 1 + i);
+            while (game->state == STATE_LIFE_LOST || game->state == STATE_START_LEVEL) core_resume(game);
+        }
+    }
+    return (bench_now_sec() - start) * 1e9 / ((double)GAMES * GAME_TICKS);
+}
+
+int main(void) {
+    GhostSet *sets = malloc(sizeof(GhostSet) * SETS);
+    if (!sets) return EXIT_FAILURE;
+
+    for (uint32_t round = 0; round < CHECK_ROUNDS; round++) {
+        fill_sets(sets, 1 + round);
+        if (!check_equivalence(sets)) {
+            fprintf(stderr, "bench_chase: chase4 kernel diverged from rules_chase_dir()\n");
+            free(sets);
+            return EXIT_FAILURE;
+        }
+    }
+    printf("equivalence: %d random ghost sets match rules_chase_dir() (%s build)\n\n", SETS * CHECK_ROUNDS, chase4_isa());
+
+    const char *names[] = {"rules_chase_dir x4", "chase4 scalar", "chase4 simd"};
+    uint32_t checksum;
+    printf("%20s %14s\n", "four-ghost decision", "ns/decision");
+    for (int kernel = 0; kernel < 3; kernel++) {
+        double ns = time_sets(sets, kernel, &checksum);
+        printf("%20s %14.2f\n", names[kernel], ns);
+    }
+    free(sets);
+
+    printf("\ncore_step(): %.1f ns/tick over %d games\n", time_ticks(), GAMES);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+#define _POSIX_C_SOURCE 199309L
+#include "core.h"
+#include "rules.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_util.h"
+
+/* Path targeting against the classic squared-distance rule. Reports the
+ * table size and build time, the cost of one ghost decision with each rule,
+ * then whole games with each ghost mode. */
+
+#define DECISIONS 65536
+#define DECISION_ROUNDS 200
+#define GAMES 64
+#define GAME_TICKS 100000u
+
+typedef struct {
+  int8_t row, col, targetRow, targetCol;
+  Direction dir;
+} Decision;
+
+// Ghosts on reachable tiles, targets anywhere around the board like Pinky's and Inky's.
+static void fill_decisions(const PathTable *paths, Decision *decisions) {
+    uint32_t rng = 12345;
+    for (int i = 0; i < DECISIONS; i++) {
+        uint16_t tile;
+        do {
+            tile = rules_rand(&rng) % MAZE_TILES;
+        } while (paths->tileIndex[tile] == PATHS_NO_INDEX);
+
+        decisions[i].row = paths->maze->tileRow[tile];
+        decisions[i].col = paths->maze->tileCol[tile];
+        decisions[i].dir = rules_rand(&rng) % DIR_COUNT;
+        decisions[i].targetRow = (int8_t)(rules_rand(&rng) % (MAP_ROWS + 8)) - 4;
+        decisions[i].targetCol = (int8_t)(rules_rand(&rng) % (MAP_COLS + 8)) - 4;
+    }
+}
+
+static double run_decisions(const PathTable *paths, const Decision *decisions, uint32_t *checksum) {
+    const Maze *maze = maze_default();
+    uint32_t sum = 0;
+
+    double start = bench_now_sec();
+    for (int round = 0; round < DECISION_ROUNDS; round++) {
+        for (int i = 0; i < DECISIONS; i++) {
+            const Decision *d = &decisions[i];
+            sum += paths ? rules_path_dir(maze, paths, d->row, d->col, d->dir, d->targetRow, d->targetCol)
+                         : rules_chase_dir(maze, d->row, d->col, d->dir, d->targetRow, d->targetCol);
+        }
+    }
+    double elapsed = bench_now_sec() - start;
+    *checksum = sum;
+    return (double)DECISIONS * DECISION_ROUNDS / elapsed;
+}
+
+// Random walking bot, so the two modes can be compared on identical inputs.
+static double run_games(const PathTable *paths, uint32_t *livesLost, uint32_t *maxScore) {
+    static GameLogic games[GAMES];
+    *livesLost = 0;
+    *maxScore = 0;
+    for (uint32_t i = 0; i < GAMES; i++) {
+        core_init(&games[i], 1 + i);
+        games[i].paths = paths;
+        core_resume(&games[i]);
+    }
+
+    double start = bench_now_sec();
+    for (uint32_t t = 0; t < GAME_TICKS; t++) {
+        for (uint32_t i = 0; i < GAMES; i++) {
+            GameLogic *game = &games[i];
+            uint32_t h = bench_script_hash(i + 1, t >> 5);
+
+            uint32_t events = core_step(game, (Direction)(h & 3));
+            if (events & (CORE_EVENT_LIFE_LOST | CORE_EVENT_GAME_OVER)) (*livesLost)++;
+            if (game->player.score > *maxScore) *maxScore = game->player.score;
+
+            if (game->state == STATE_GAME_OVER || game->state == STATE_GAME_COMPLETE) {
+                core_init(game, 1 + i);
+                game->paths = paths;
+            }
+            while (game->state == STATE_LIFE_LOST || game->state == STATE_START_LEVEL) core_resume(game);
+        }
+    }
+    return (double)GAMES * GAME_TICKS / (bench_now_sec() - start);
+}
+
+int main(void) {
+    double start = bench_now_sec();
+    const PathTable *paths = paths_default();
+    double buildMs = (bench_now_sec() - start) * 1e3;
+    if (!paths) {
+        fprintf(stderr, "bench_paths: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    uint8_t longest = 0;
+    for (uint32_t i = 0; i < (uint32_t)paths->count * paths->count; i++) {
+        if (paths->steps[i] != PATHS_FAR && paths->steps[i] > longest) longest = paths->steps[i];
+    }
+    printf("path table: %u tiles, %u bytes, longest path %u steps, built in %.2f ms\n\n",
+           paths->count, (unsigned)paths->count * paths->count, longest, buildMs);
+
+    Decision *decisions = malloc(sizeof(Decision) * DECISIONS);
+    if (!decisions) return EXIT_FAILURE;
+    fill_decisions(paths, decisions);
+
+    uint32_t chaseSum, pathSum;
+    double chase = run_decisions(NULL, decisions, &chaseSum);
+    double path = run_decisions(paths, decisions, &pathSum);
+    uint32_t differ = 0;
+    for (int i = 0; i < DECISIONS; i++) {
+        const Decision *d = &decisions[i];
+        differ += rules_chase_dir(maze_default(), d->row, d->col, d->dir, d->targetRow, d->targetCol) !=
+                  rules_path_dir(maze_default(), paths, d->row, d->col, d->dir, d->targetRow, d->targetCol);
+    }
+    free(decisions);
+
+    printf("%10s %16s\n", "rule", "decisions/s");
+    printf("%10s %16.0f\n", "squared", chase);
+    printf("%10s %16.0f\n", "path", path);
+    printf("path picks a different move in %.1f%% of decisions (checksums %u/%u)\n\n",
+           100.0 * differ / DECISIONS, chaseSum, pathSum);
+
+    printf("%10s %16s %12s %10s\n", "ghosts", "ticks/s", "lives lost", "top score");
+    uint32_t lost, top;
+    double ticks = run_games(NULL, &lost, &top);
+    printf("%10s %16.0f %12u %10u\n", "squared", ticks, lost, top);
+    ticks = run_games(paths, &lost, &top);
+    printf("%10s %16.0f %12u %10u\n", "path", ticks, lost, top);
+    return EXIT_SUCCESS;
+}
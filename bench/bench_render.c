@@ -0,0 +1,219 @@
+/* Frame cost of every screen, offscreen: SDL's dummy video driver, the
+ * software renderer drawing into the window surface, no vsync. Each scenario
+ * puts the game in a fixed state, draws WARMUP + FRAMES frames with the
+ * render_*_state() functions and reports frames/s and frame time percentiles.
+ * The playing scenarios step the game one tick per frame with scripted input
+ * from a fixed seed, so they eat dots and patch the maze as a real game does.
+ *
+ * The last frame of each scenario is compared with bench/golden/NAME.png. A
+ * different frame fails the run and is written to bin/bench_render_NAME.png;
+ * so does a missing golden, unless --update is given, which (re)records every
+ * golden from this run into bench/golden, created if need be. The makefile
+ * builds glyphs.c with GLYPH_SOLID, so the text in the frames is the bundled
+ * PressStart2P at the UI's fixed sizes with no antialiasing, and does not
+ * depend on how a given SDL_ttf smooths edges.
+ *
+ *   bench_render [--soft] [--update]
+ *
+ * --soft benches the software backend (include/softframe.h) against the same
+ * goldens. The bench links the game's own objects and reaches the render
+ * functions through src/game.h. The makefile builds rank.c with a SCORE_FILE
+ * of its own, so init and quit load and save bin/bench_render_scores.bin. */
+
+#define _POSIX_C_SOURCE 200809L
+#include "bench_util.h"
+#include "game.h"
+
+#define WARMUP 30
+#define FRAMES 300
+#define GOLDEN_DIR "bench/golden"
+#define SEED 1
+
+typedef struct {
+  const char *name;
+  GameState state;
+  bool live;  // steps the game one tick before each frame
+  bool world; // the generated maze instead of the classic board
+} Scenario;
+
+// In order: the playing ones leave the board the later ones are drawn over.
+static const Scenario scenarios[] = {
+  {"menu", STATE_MENU, false, false},
+  {"help", STATE_HELP, false, false},
+  {"ranking", STATE_RANKING, false, false},
+  {"enter_name", STATE_ENTER_NAME, false, false},
+  {"start_level", STATE_START_LEVEL, false, false},
+  {"playing", STATE_PLAYING, true, false},
+  {"paused", STATE_PAUSED, false, false},
+  {"life_lost", STATE_LIFE_LOST, false, false},
+  {"game_over", STATE_GAME_OVER, false, false},
+  {"game_complete", STATE_GAME_COMPLETE, false, false},
+  {"world", STATE_PLAYING, true, true},
+};
+
+typedef enum {
+  GOLDEN_MATCH,
+  GOLDEN_RECORDED,
+  GOLDEN_MISSING,
+  GOLDEN_DIFFERS,
+  GOLDEN_ERROR
+} GoldenResult;
+
+static const char *goldenNames[] = {"match", "recorded", "MISSING", "DIFFERS", "error"};
+
+// What render() would call for the state, drawn every frame even on static screens.
+static void draw_state(AppContext *app, GameState state, bool entering) {
+    switch (state) {
+        case STATE_MENU: render_menu_state(app); break;
+        case STATE_HELP: render_help_state(app); break;
+        case STATE_RANKING: render_ranking_state(app); break;
+        case STATE_ENTER_NAME: render_enter_name_state(app); break;
+        case STATE_START_LEVEL: render_start_level_state(app, entering); break;
+        case STATE_PLAYING: render_playing_state(app, true); break;
+        case STATE_PAUSED: render_paused_state(app); break;
+        case STATE_LIFE_LOST: render_life_lost_state(app, entering); break;
+        case STATE_GAME_OVER: render_game_over_state(app, entering); break;
+        case STATE_GAME_COMPLETE: render_game_complete_state(app, entering); break;
+    }
+}
+
+// The same hash walk as bench_world: a new direction every few frames.
+static Direction scripted_input(uint32_t frame) {
+    return (Direction)(bench_script_hash(1, frame >> 3) & 3);
+}
+
+static void fixed_board(ScoreBoard *board) {
+    static const char names[][MAX_NAME_LEN + 1] = {"ALICE", "BOB", "CAROL", "DAVE", "EVE"};
+    memset(board, 0, sizeof(ScoreBoard));
+    for (int i = 0; i < 5; i++) add_score(board, names[i], (uint16_t)(5000 - i * 750));
+}
+
+// Compares RGB only: the window surface has no alpha to keep.
+static GoldenResult check_golden(SDL_Window *window, const char *name, bool update, long *differing) {
+    char golden[256], actual[256];
+    snprintf(golden, sizeof(golden), GOLDEN_DIR "/%s.png", name);
+    snprintf(actual, sizeof(actual), "bin/bench_render_%s.png", name);
+    *differing = 0;
+
+    SDL_Surface *frame = SDL_ConvertSurfaceFormat(SDL_GetWindowSurface(window), SDL_PIXELFORMAT_RGBA32, 0);
+    if (!frame) return GOLDEN_ERROR;
+
+    if (update) {
+        MKDIR(GOLDEN_DIR);
+        GoldenResult result = IMG_SavePNG(frame, golden) == 0 ? GOLDEN_RECORDED : GOLDEN_ERROR;
+        SDL_FreeSurface(frame);
+        return result;
+    }
+    SDL_Surface *loaded = IMG_Load(golden);
+    if (!loaded) {
+        IMG_SavePNG(frame, actual);
+        SDL_FreeSurface(frame);
+        return GOLDEN_MISSING;
+    }
+    SDL_Surface *expected = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!expected) {
+        SDL_FreeSurface(frame);
+        return GOLDEN_ERROR;
+    }
+
+    if (expected->w != frame->w || expected->h != frame->h) {
+        *differing = (long)frame->w * frame->h;
+    } else {
+        for (int y = 0; y < frame->h; y++) {
+            const uint8_t *a = (const uint8_t *)frame->pixels + y * frame->pitch;
+            const uint8_t *b = (const uint8_t *)expected->pixels + y * expected->pitch;
+            for (int x = 0; x < frame->w * 4; x += 4) {
+                *differing += a[x] != b[x] || a[x + 1] != b[x + 1] || a[x + 2] != b[x + 2];
+            }
+        }
+    }
+    if (*differing) IMG_SavePNG(frame, actual);
+    SDL_FreeSurface(expected);
+    SDL_FreeSurface(frame);
+    return *differing ? GOLDEN_DIFFERS : GOLDEN_MATCH;
+}
+
+int main(int argc, char *argv[]) {
+    bool soft = false, update = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--soft") == 0) soft = true;
+        else if (strcmp(argv[i], "--update") == 0) update = true;
+    }
+
+    // Offscreen and unpaced, unless the environment asks for something else
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+
+    static AppContext app;
+    static World world;
+    init_game_application(&app, soft);
+    fixed_board(&app.board);
+    snprintf(app.ui.scoreboard.playerName.text, MAX_NAME_LEN + 1, "BENCH");
+    core_init(&app.game, SEED);
+    reset_motion(&app);
+    app.mazeLayer.rebuild = true;
+    app.ui.overlay.score.needsUpdate = true;
+    app.timer.frameMs = 0; // timelines stay on their first step
+
+    static double frameMs[FRAMES];
+    bool failed = false, missing = false;
+    uint64_t frequency = SDL_GetPerformanceFrequency();
+    printf("backend: %s\n", soft ? "soft (window surface, dirty rects)" : "software renderer");
+    printf("%-14s %10s %9s %9s %9s %9s %12s  %s\n", "scenario", "frames/s", "p50 ms", "p95 ms", "p99 ms", "max ms", "draws/frame", "golden");
+
+    for (size_t s = 0; s < SDL_arraysize(scenarios); s++) {
+        const Scenario *scenario = &scenarios[s];
+        if (scenario->world) {
+            if (!world_init(&world, 255, 255, SEED)) {
+                show_error_and_quit("Memory error", "Out of memory or null pointer: world chunk table", &app);
+            }
+            app.world = &world;
+            app.ui.overlay.score.needsUpdate = true;
+        }
+        app.game.state = scenario->state;
+        hold_screen_assets(&app, screen_assets(scenario->state));
+
+        uint64_t total = 0;
+        for (int f = 0; f < WARMUP + FRAMES; f++) {
+            if (f == WARMUP) app.stats.drawCalls = 0;
+            uint64_t start = SDL_GetPerformanceCounter();
+            if (scenario->live) {
+                app.input = scripted_input((uint32_t)f);
+                update_game(&app, 1);
+            }
+            draw_state(&app, scenario->state, f == 0);
+            uint64_t elapsed = SDL_GetPerformanceCounter() - start;
+            if (f >= WARMUP) {
+                frameMs[f - WARMUP] = (double)elapsed * 1000.0 / frequency;
+                total += elapsed;
+            }
+        }
+        uint32_t drawCalls = app.stats.drawCalls;
+
+        long differing;
+        GoldenResult golden = check_golden(app.window, scenario->name, update, &differing);
+        failed |= golden == GOLDEN_MISSING || golden == GOLDEN_DIFFERS || golden == GOLDEN_ERROR;
+        missing |= golden == GOLDEN_MISSING;
+
+        qsort(frameMs, FRAMES, sizeof(double), bench_compare_doubles);
+        printf("%-14s %10.0f %9.3f %9.3f %9.3f %9.3f %12.1f  %s", scenario->name,
+               FRAMES * (double)frequency / (total ? total : 1), bench_percentile(frameMs, FRAMES, 0.50),
+               bench_percentile(frameMs, FRAMES, 0.95), bench_percentile(frameMs, FRAMES, 0.99), frameMs[FRAMES - 1],
+               (double)drawCalls / FRAMES, goldenNames[golden]);
+        if (golden == GOLDEN_DIFFERS) printf(" (%ld px, see bin/bench_render_%s.png)", differing, scenario->name);
+        if (golden == GOLDEN_MISSING) printf(" (frame in bin/bench_render_%s.png)", scenario->name);
+        printf("\n");
+
+        if (scenario->world) {
+            app.world = NULL;
+            world_free(&world);
+        }
+    }
+
+    quit_game_application(&app);
+    if (missing) printf("no golden for some scenarios: record them with --update, then commit bench/golden\n");
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,129 @@
+#define _POSIX_C_SOURCE 199309L
+#include "core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_util.h"
+
+/* Event-driven stepping against the fixed tick loop. First checks that
+ * core_advance() leaves every game in exactly the state core_step() does,
+ * then reports simulated ticks/sec for both as the time between inputs grows. */
+
+#define CHECK_GAMES 64
+#define CHECK_TICKS 20000
+#define BENCH_GAMES 64
+#define BENCH_TICKS 200000u
+
+// Same scripted bot as bench_batch: a new random direction every `span` ticks.
+static Direction bot_input(uint32_t game, uint32_t tick, uint32_t span) {
+    uint32_t h = bench_script_hash(game + 1, tick / span);
+    return (h & 7) < 4 ? (Direction)(h & 3) : DIR_COUNT;
+}
+
+static void resume_game(GameLogic *game, uint32_t seed) {
+    if (game->state == STATE_GAME_OVER || game->state == STATE_GAME_COMPLETE) core_init(game, seed);
+    while (game->state == STATE_LIFE_LOST || game->state == STATE_START_LEVEL) core_resume(game);
+}
+
+// Runs `ticks` ticks of one input with core_advance(), resuming games like the tick loop does.
+static void advance_span(GameLogic *game, uint32_t seed, uint32_t ticks, Direction input, uint32_t stopEvents) {
+    while (ticks > 0) {
+        uint32_t done;
+        core_advance(game, ticks, input, stopEvents, &done);
+        if (done == 0) done = 1; // a tick spent outside STATE_PLAYING
+        ticks -= done;
+        input = DIR_COUNT;
+        resume_game(game, seed);
+    }
+}
+
+static bool check_equivalence(uint32_t span, uint32_t stopEvents) {
+    static GameLogic ticked[CHECK_GAMES], evented[CHECK_GAMES];
+    for (uint32_t i = 0; i < CHECK_GAMES; i++) {
+        core_init(&ticked[i], 1 + i);
+        resume_game(&ticked[i], 1 + i);
+        core_init(&evented[i], 1 + i);
+        resume_game(&evented[i], 1 + i);
+    }
+
+    for (uint32_t t = 0; t < CHECK_TICKS; t += span) {
+        for (uint32_t i = 0; i < CHECK_GAMES; i++) {
+            Direction input = bot_input(i, t, span);
+            for (uint32_t k = 0; k < span; k++) {
+                core_step(&ticked[i], k == 0 ? input : DIR_COUNT);
+                resume_game(&ticked[i], 1 + i);
+            }
+            advance_span(&evented[i], 1 + i, span, input, stopEvents);
+
+            if (!core_same_state(&ticked[i], &evented[i])) {
+                fprintf(stderr, "mismatch: game %u at tick %u (span %u)\n", i, t + span, span);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static double run_ticked(uint32_t span) {
+    static GameLogic games[BENCH_GAMES];
+    for (uint32_t i = 0; i < BENCH_GAMES; i++) {
+        core_init(&games[i], 1 + i);
+        resume_game(&games[i], 1 + i);
+    }
+
+    double start = bench_now_sec();
+    for (uint32_t t = 0; t < BENCH_TICKS; t += span) {
+        for (uint32_t i = 0; i < BENCH_GAMES; i++) {
+            Direction input = bot_input(i, t, span);
+            for (uint32_t k = 0; k < span; k++) {
+                core_step(&games[i], k == 0 ? input : DIR_COUNT);
+                resume_game(&games[i], 1 + i);
+            }
+        }
+    }
+    return (double)BENCH_GAMES * BENCH_TICKS / (bench_now_sec() - start);
+}
+
+static double run_evented(uint32_t span) {
+    static GameLogic games[BENCH_GAMES];
+    for (uint32_t i = 0; i < BENCH_GAMES; i++) {
+        core_init(&games[i], 1 + i);
+        resume_game(&games[i], 1 + i);
+    }
+
+    double start = bench_now_sec();
+    for (uint32_t t = 0; t < BENCH_TICKS; t += span) {
+        for (uint32_t i = 0; i < BENCH_GAMES; i++) {
+            Direction input = bot_input(i, t, span);
+            uint32_t ticks = span;
+            while (ticks > 0) {
+                uint32_t done;
+                core_advance(&games[i], ticks, input, 0, &done);
+                ticks -= done ? done : 1;
+                input = DIR_COUNT;
+                resume_game(&games[i], 1 + i);
+            }
+        }
+    }
+    return (double)BENCH_GAMES * BENCH_TICKS / (bench_now_sec() - start);
+}
+
+int main(void) {
+    const uint32_t spans[] = {1, 8, 32, 256, 4096};
+    const size_t spanCount = sizeof(spans) / sizeof(spans[0]);
+
+    for (size_t s = 0; s < spanCount; s++) {
+        if (!check_equivalence(spans[s], 0) || !check_equivalence(spans[s], UINT32_MAX)) {
+            fprintf(stderr, "bench_sched: core_advance() diverged from core_step()\n");
+            return EXIT_FAILURE;
+        }
+    }
+    printf("equivalence: %d games x %d ticks match core_step()\n\n", CHECK_GAMES, CHECK_TICKS);
+
+    printf("%12s %16s %16s %8s\n", "input every", "tick loop t/s", "event mode t/s", "speedup");
+    for (size_t s = 0; s < spanCount; s++) {
+        double ticked = run_ticked(spans[s]);
+        double evented = run_evented(spans[s]);
+        printf("%12u %16.0f %16.0f %7.2fx\n", spans[s], ticked, evented, ticked > 0 ? evented / ticked : 0);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,187 @@
+#define _POSIX_C_SOURCE 199309L
+#include "core.h"
+#include "step.h"
+#include "rank.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_util.h"
+
+/* Micro-benchmarks of the simulation and the score table, for tracking
+ * regressions between releases. Every case starts from the same state (fixed
+ * seed, fixed scripted input), runs warm-up samples that are thrown away,
+ * then times SAMPLES batches of opsPerSample calls. Prints the median and p99
+ * ns/op over the batches and writes the same numbers as JSON.
+ *
+ *   bench_sim [results.json]
+ *
+ * The score cases read and write bin/bench_sim_scores.bin: the makefile
+ * builds rank.c with that SCORE_FILE, the game's table is never touched. */
+
+#define SEED 1
+#define MIDGAME_TICKS 600 // ghosts out of the house, a good part of the dots eaten
+#define STEP_TICKS 600    // one tick sample: ten seconds of play from the midgame state
+#define WARMUP_SAMPLES 20
+
+typedef struct {
+  const char *name;
+  uint64_t (*run)(uint32_t count); // count calls, returns something that depends on them
+  uint32_t opsPerSample;
+  uint32_t samples;
+} SimBench;
+
+static GameLogic midgame;
+static ScoreBoard fullBoard;
+static const char benchName[MAX_NAME_LEN + 1] = "BENCH";
+
+// The same hash walk as bench_world: a new direction every few ticks.
+static Direction scripted_input(uint32_t tick) {
+    return (Direction)(bench_script_hash(1, tick >> 3) & 3);
+}
+
+// Lives are topped up so deaths only cost a position reset, never the game.
+static void step_scripted(GameLogic *game, uint32_t tick) {
+    core_step(game, scripted_input(tick));
+    while (game->state == STATE_LIFE_LOST || game->state == STATE_START_LEVEL) core_resume(game);
+}
+
+static void build_fixtures(void) {
+    core_init(&midgame, SEED);
+    midgame.player.lives = 99;
+    midgame.state = STATE_PLAYING;
+    for (uint32_t t = 0; t < MIDGAME_TICKS; t++) step_scripted(&midgame, t);
+    midgame.player.lives = 99;
+
+    memset(&fullBoard, 0, sizeof(ScoreBoard));
+    for (int i = 0; i < MAX_SCORES; i++) add_score(&fullBoard, benchName, (uint16_t)(1000 + i * 250));
+}
+
+// Pacman stepping out of his midgame tile in each direction, walls and the tunnel included.
+static uint64_t run_try_move(uint32_t count) {
+    GameLogic game = midgame;
+    uint64_t sink = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        GameEntity pacman = midgame.player.pacman;
+        sink += core_try_move(&game, &pacman, (Direction)(i & 3)) + pacman.row;
+    }
+    return sink;
+}
+
+// All four ghosts due on every call: the worst case a tick can ask for.
+static uint64_t run_update_ghosts(uint32_t count) {
+    GameLogic game = midgame;
+    uint64_t sink = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        for (int g = 0; g < 4; g++) game.ghosts[g].moveTimer = UINT16_MAX - DELTA_TICK;
+        core_update_ghosts(&game);
+        sink += game.ghosts[i & 3].row;
+    }
+    return sink;
+}
+
+// No one on pacman's tile, as on nearly every tick.
+static uint64_t run_check_collisions(uint32_t count) {
+    GameLogic game = midgame;
+    uint64_t sink = 0;
+    for (uint32_t i = 0; i < count; i++) sink += core_check_collisions(&game);
+    return sink;
+}
+
+// What update_game() runs per tick, without the SDL side: consecutive ticks from the midgame state.
+static uint64_t run_core_step(uint32_t count) {
+    GameLogic game = midgame;
+    uint64_t sink = 0;
+    for (uint32_t t = 0; t < count; t++) {
+        step_scripted(&game, MIDGAME_TICKS + t);
+        sink += game.events;
+    }
+    return sink + game.player.score;
+}
+
+static uint64_t run_init_level(uint32_t count) {
+    GameLogic game = midgame;
+    uint64_t sink = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        core_init_level(&game, false);
+        sink += game.player.pacman.row;
+    }
+    return sink;
+}
+
+// Into a full table, landing anywhere from first place to off the end.
+static uint64_t run_add_score(uint32_t count) {
+    uint64_t sink = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        ScoreBoard board = fullBoard;
+        add_score(&board, benchName, (uint16_t)(i * 389 % 4000));
+        sink += board.scores[MAX_SCORES - 1].score;
+    }
+    return sink;
+}
+
+static uint64_t run_save_scores(uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) save_scores(&fullBoard);
+    return count;
+}
+
+static uint64_t run_load_scores(uint32_t count) {
+    uint64_t sink = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        ScoreBoard board;
+        load_scores(&board);
+        sink += board.count;
+    }
+    return sink;
+}
+
+// save_scores first, so load_scores reads the fixed table
+static const SimBench benches[] = {
+  {"try_move", run_try_move, 1024, 1000},
+  {"update_ghosts", run_update_ghosts, 256, 1000},
+  {"check_collisions", run_check_collisions, 1024, 1000},
+  {"core_step", run_core_step, STEP_TICKS, 1000},
+  {"core_init_level", run_init_level, 64, 1000},
+  {"add_score", run_add_score, 1024, 1000},
+  {"save_scores", run_save_scores, 1, 200},
+  {"load_scores", run_load_scores, 1, 200},
+};
+
+int main(int argc, char *argv[]) {
+    const char *jsonPath = argc > 1 ? argv[1] : "bin/bench_sim.json";
+    static double nsPerOp[1000];
+    double median[sizeof(benches) / sizeof(benches[0])], p99[sizeof(benches) / sizeof(benches[0])];
+    volatile uint64_t sink = 0;
+
+    build_fixtures();
+
+    printf("%-18s %10s %12s %12s\n", "case", "ops", "median ns", "p99 ns");
+    for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        const SimBench *bench = &benches[b];
+        for (int w = 0; w < WARMUP_SAMPLES; w++) sink += bench->run(bench->opsPerSample);
+        for (uint32_t s = 0; s < bench->samples; s++) {
+            double start = bench_now_sec();
+            sink += bench->run(bench->opsPerSample);
+            nsPerOp[s] = (bench_now_sec() - start) * 1e9 / bench->opsPerSample;
+        }
+        qsort(nsPerOp, bench->samples, sizeof(double), bench_compare_doubles);
+        median[b] = bench_percentile(nsPerOp, bench->samples, 0.50);
+        p99[b] = bench_percentile(nsPerOp, bench->samples, 0.99);
+        printf("%-18s %10u %12.1f %12.1f\n", bench->name, bench->opsPerSample * bench->samples, median[b], p99[b]);
+    }
+
+    FILE *json = fopen(jsonPath, "w");
+    if (!json) {
+        perror(jsonPath);
+        return EXIT_FAILURE;
+    }
+    fprintf(json, "{\n  \"suite\": \"sim\",\n  \"seed\": %d,\n  \"unit\": \"ns/op\",\n  \"results\": [\n", SEED);
+    for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        fprintf(json, "    {\"name\": \"%s\", \"ops_per_sample\": %u, \"samples\": %u, \"median_ns\": %.1f, \"p99_ns\": %.1f}%s\n",
+                benches[b].name, benches[b].opsPerSample, benches[b].samples, median[b], p99[b],
+                b + 1 < sizeof(benches) / sizeof(benches[0]) ? "," : "");
+    }
+    fprintf(json, "  ]\n}\n");
+    fclose(json);
+    printf("results: %s (checksum %llu)\n", jsonPath, (unsigned long long)sink);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+#include "simthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Stress test of the --threaded handover (include/simthread.h). The sim
+ * thread ticks every millisecond while the main thread plays, polls and stops
+ * sessions of random length, from a stop straight after play to about twenty
+ * milliseconds, and restarts the thread every RESTART_EVERY cycles. Fails on:
+ *   - a snapshot older than the one read before it (the sim clock, or any of
+ *     the event counts, going backwards),
+ *   - a session that hands the game back without publishing a snapshot,
+ *   - a final snapshot that is not the game the main thread gets back. */
+
+#define CYCLES 1000
+#define RESTART_EVERY 50
+#define TICK_RATE_HZ 1000
+#define MAX_POLLS 20
+
+typedef struct {
+  uint64_t snapshots, ticks, sessionsEnded, inputsDropped;
+} StressCounts;
+
+// xorshift32, as rules_rand() does in the core
+static uint32_t next_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void resume_game(GameLogic *game, uint32_t seed) {
+    if (game->state == STATE_GAME_OVER || game->state == STATE_GAME_COMPLETE) core_init(game, seed);
+    while (game->state == STATE_LIFE_LOST || game->state == STATE_START_LEVEL) core_resume(game);
+}
+
+// Takes the newest snapshot if there is one and checks it is not older than `last`.
+static bool read_snapshot(SimThread *sim, SimSnapshot *last, bool *any, StressCounts *counts) {
+    const SimSnapshot *snapshot = sim_thread_latest(sim);
+    if (!snapshot) return true;
+
+    if (*any && snapshot->clock.ticks < last->clock.ticks) return false;
+    for (int bit = 0; bit < SIM_EVENT_BITS; bit++) {
+        if (snapshot->eventCounts[bit] < last->eventCounts[bit]) return false;
+    }
+    *last = *snapshot;
+    *any = true;
+    counts->snapshots++;
+    return true;
+}
+
+int main(void) {
+    static SimThread sim;
+    static GameLogic game;
+    static SimSnapshot last;
+    StressCounts counts = {0};
+    uint32_t rng = 1;
+
+    core_init(&game, 1);
+    resume_game(&game, 1);
+
+    uint64_t start = SDL_GetPerformanceCounter();
+    for (uint32_t cycle = 0; cycle < CYCLES; cycle++) {
+        if (cycle % RESTART_EVERY == 0) {
+            if (cycle > 0) sim_thread_quit(&sim);
+            if (!sim_thread_start(&sim, TICK_RATE_HZ)) {
+                fprintf(stderr, "bench_simthread: %s\n", SDL_GetError());
+                return EXIT_FAILURE;
+            }
+            memset(&last.eventCounts, 0, sizeof(last.eventCounts)); // counted per thread
+        }
+
+        // The sim clock starts over with each session
+        last.clock.ticks = 0;
+        bool any = false;
+        sim_thread_play(&sim, &game);
+
+        uint32_t polls = next_rand(&rng) % (MAX_POLLS + 1);
+        for (uint32_t p = 0; p < polls; p++) {
+            if (!sim_thread_input(&sim, (Direction)(next_rand(&rng) & 3))) counts.inputsDropped++;
+            if (!read_snapshot(&sim, &last, &any, &counts)) {
+                fprintf(stderr, "bench_simthread: snapshot older than the previous one (cycle %u)\n", cycle);
+                return EXIT_FAILURE;
+            }
+            SDL_Delay(next_rand(&rng) % 2);
+        }
+
+        sim_thread_stop(&sim);
+        if (!read_snapshot(&sim, &last, &any, &counts)) {
+            fprintf(stderr, "bench_simthread: final snapshot older than the previous one (cycle %u)\n", cycle);
+            return EXIT_FAILURE;
+        }
+        if (!any) {
+            fprintf(stderr, "bench_simthread: session handed back without a snapshot (cycle %u)\n", cycle);
+            return EXIT_FAILURE;
+        }
+        // The game is the main thread's again: the last snapshot must be all of it
+        if (!core_same_state(&last.game, &sim.game)) {
+            fprintf(stderr, "bench_simthread: final snapshot differs from the returned game (cycle %u)\n", cycle);
+            return EXIT_FAILURE;
+        }
+
+        counts.ticks += last.clock.ticks;
+        if (sim.game.state != STATE_PLAYING) counts.sessionsEnded++;
+        game = sim.game;
+        resume_game(&game, 1 + cycle);
+    }
+    sim_thread_quit(&sim);
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+    printf("%u play/stop cycles, %u thread restarts in %.2f s\n", CYCLES, CYCLES / RESTART_EVERY, seconds);
+    printf("%llu snapshots read, %llu ticks, %llu sessions ended by the game, %llu inputs dropped\n",
+           (unsigned long long)counts.snapshots, (unsigned long long)counts.ticks,
+           (unsigned long long)counts.sessionsEnded, (unsigned long long)counts.inputsDropped);
+    printf("ok: snapshots never went back in time and every handover returned the final snapshot\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,37 @@
+#define _POSIX_C_SOURCE 199309L
+#include "swarm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_util.h"
+
+/* Mass-ghost mode: how the cost of one tick grows with the number of ghosts.
+ * Pacman is driven by the same scripted bot as the other benches, and lives
+ * lost restart the level, so every run keeps a crowded board. */
+
+#define TICKS 20000u
+
+int main(void) {
+    const uint32_t counts[] = {4, 16, 64, 256, 1024, 4096, 16384};
+
+    printf("%8s %12s %14s %12s %12s\n", "ghosts", "ns/tick", "ns/ghost-tick", "lives lost", "flow builds");
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        Swarm swarm;
+        if (!swarm_init(&swarm, counts[c], 1)) {
+            fprintf(stderr, "bench_swarm: out of memory at %u ghosts\n", counts[c]);
+            return EXIT_FAILURE;
+        }
+
+        uint32_t livesLost = 0;
+        double start = bench_now_sec();
+        for (uint32_t t = 0; t < TICKS; t++) {
+            uint32_t h = bench_script_hash(1, t >> 5);
+            uint32_t events = swarm_step(&swarm, (h & 7) < 4 ? (Direction)(h & 3) : DIR_COUNT);
+            if (events & (CORE_EVENT_LIFE_LOST | CORE_EVENT_GAME_OVER)) livesLost++;
+        }
+        double ns = (bench_now_sec() - start) * 1e9 / TICKS;
+
+        printf("%8u %12.0f %14.2f %12u %12u\n", counts[c], ns, ns / counts[c], livesLost, swarm.flowBuilds);
+        swarm_free(&swarm);
+    }
+    return EXIT_SUCCESS;
+}
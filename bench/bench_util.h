@@ -0,0 +1,40 @@
+#ifndef PACMAN_BENCH_UTIL_H
+#define PACMAN_BENCH_UTIL_H
+
+/* What every bench shares: a monotonic clock, the hash behind the scripted
+ * inputs and percentiles over timed samples. Header only, each bench is a
+ * single file. clock_gettime() needs _POSIX_C_SOURCE defined before the
+ * first system header, so benches define it on their first line. */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+static inline double bench_now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Scripted input: the same word for the same (stream, step) on every run.
+// Benches step once every few ticks and pick a direction from the low bits.
+static inline uint32_t bench_script_hash(uint32_t stream, uint32_t step) {
+    uint32_t h = stream * 2654435761u ^ step * 2246822519u;
+    h ^= h >> 15;
+    return h;
+}
+
+static inline int bench_compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest rank, p in [0, 1], over samples sorted with bench_compare_doubles().
+static inline double bench_percentile(const double *sorted, uint32_t count, double p) {
+    int i = (int)(p * count + 0.5) - 1;
+    if (i < 0) i = 0;
+    if (i > (int)count - 1) i = (int)count - 1;
+    return sorted[i];
+}
+
+#endif
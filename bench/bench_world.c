@@ -0,0 +1,64 @@
+#define _POSIX_C_SOURCE 199309L
+#include "world.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_util.h"
+
+/* Per-frame cost of a procedurally generated world as it grows. Each frame
+ * steps Pacman once and walks the tiles the renderer would draw (visible
+ * chunks only), so the time should stay flat from 31x31 up to 4095x4095. */
+
+#define FRAMES 20000
+#define VIEW_ROWS 31 // the classic board, as seen through the game window
+#define VIEW_COLS 29
+
+// What render_world_state() touches: every visible tile of every visible chunk.
+static uint32_t draw_view(World *world) {
+    WorldView view;
+    uint32_t drawn = 0;
+    world_view(world, VIEW_ROWS, VIEW_COLS, &view);
+
+    for (int32_t cr = view.firstChunkRow; cr <= view.lastChunkRow; cr++) {
+        for (int32_t cc = view.firstChunkCol; cc <= view.lastChunkCol; cc++) {
+            const WorldChunk *chunk = world_chunk(world, cr, cc);
+            if (!chunk) continue;
+
+            for (int32_t row = cr * WORLD_CHUNK; row < (cr + 1) * WORLD_CHUNK; row++) {
+                if (row < view.firstRow || row > view.lastRow) continue;
+                uint32_t shown = chunk->walls[row % WORLD_CHUNK] | chunk->dots[row % WORLD_CHUNK];
+                for (int32_t col = cc * WORLD_CHUNK; col < (cc + 1) * WORLD_CHUNK; col++) {
+                    if (col < view.firstCol || col > view.lastCol) continue;
+                    drawn += (shown >> (col % WORLD_CHUNK)) & 1;
+                }
+            }
+        }
+    }
+    return drawn;
+}
+
+int main(void) {
+    const int32_t sides[] = {31, 255, 1023, 4095};
+
+    printf("%10s %12s %14s %14s %12s\n", "maze", "ns/frame", "tiles drawn", "chunks built", "chunk KiB");
+    for (size_t s = 0; s < sizeof(sides) / sizeof(sides[0]); s++) {
+        World world;
+        if (!world_init(&world, sides[s], sides[s], 1)) {
+            fprintf(stderr, "bench_world: out of memory at %d tiles per side\n", sides[s]);
+            return EXIT_FAILURE;
+        }
+
+        uint64_t drawn = 0;
+        double start = bench_now_sec();
+        for (uint32_t f = 0; f < FRAMES; f++) {
+            uint32_t h = bench_script_hash(1, f >> 5);
+            world_step(&world, (Direction)(h & 3));
+            drawn += draw_view(&world);
+        }
+        double ns = (bench_now_sec() - start) * 1e9 / FRAMES;
+
+        printf("%5dx%-4d %12.0f %14.0f %14u %12.1f\n", world.rows, world.cols, ns, (double)drawn / FRAMES,
+               world.chunksBuilt, world.chunksBuilt * sizeof(WorldChunk) / 1024.0);
+        world_free(&world);
+    }
+    return EXIT_SUCCESS;
+}
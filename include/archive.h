@@ -0,0 +1,82 @@
+#ifndef PACMAN_ARCHIVE_H
+#define PACMAN_ARCHIVE_H
+
+/* Packed assets. tools/pack.c turns assets/ into assets.pak at build time with
+ * everything the game would otherwise decode at startup already decoded:
+ * images as RGBA32 pixels, sounds as PCM in the mixer's output format, fonts
+ * and anything else as the file bytes. The game maps the file and makes
+ * textures, chunks and fonts straight from the mapped pages; the mapping stays
+ * for the whole run, so chunks and fonts read from it without a copy.
+ *
+ * Layout: ArchiveHeader, count ArchiveEntry records, then each entry's data at
+ * an ARCHIVE_ALIGN boundary. Native endianness, like the .lvl files. */
+
+#if defined(_WIN32) || defined(__APPLE__)
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ARCHIVE_MAGIC 0x41434150u // "PACA" read as a little endian uint32_t
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_NAME_MAX 48       // path under assets/ with '/' separators, NUL included
+#define ARCHIVE_ALIGN 64
+
+// The mixer is opened with these; sounds are baked for exactly this output.
+#define ARCHIVE_AUDIO_FREQ 44100
+#define ARCHIVE_AUDIO_FORMAT AUDIO_S16SYS
+#define ARCHIVE_AUDIO_CHANNELS 2
+
+// Longer WAVs stay as the file bytes, for Mix_LoadMUS_RW() to decode while they play.
+#define ARCHIVE_STREAM_BYTES (64 * 1024)
+
+typedef enum {
+  ARCHIVE_BLOB,   // file bytes as they are (fonts, streamed sounds)
+  ARCHIVE_IMAGE,  // width * height RGBA32 pixels, rows packed
+  ARCHIVE_SOUND   // PCM in ARCHIVE_AUDIO_FORMAT, ARCHIVE_AUDIO_CHANNELS at ARCHIVE_AUDIO_FREQ
+} ArchiveKind;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t count;  // entries after the header
+  uint32_t bytes;  // whole file
+} ArchiveHeader;
+
+typedef struct {
+  char name[ARCHIVE_NAME_MAX];
+  uint32_t kind;
+  uint32_t offset, size;  // from the start of the file
+  uint32_t width, height; // ARCHIVE_IMAGE only
+} ArchiveEntry;
+
+typedef struct {
+  const uint8_t *data;  // the mapped file, NULL when not open
+  size_t size;
+  const ArchiveEntry *entries;
+  uint32_t count;
+#ifdef _WIN32
+  void *file, *mapping;
+#endif
+} Archive;
+
+bool archive_open(Archive *archive, const char *path); // false if missing, unmappable or malformed
+void archive_close(Archive *archive);
+const ArchiveEntry *archive_find(const Archive *archive, const char *name);
+
+// NULL when the entry is missing, of another kind, or SDL fails; load the loose file then.
+SDL_Texture *archive_texture(const Archive *archive, SDL_Renderer *renderer, const char *name);
+SDL_Surface *archive_surface(const Archive *archive, const char *name); // reads the mapping, valid while it is open
+Mix_Chunk *archive_chunk(const Archive *archive, const char *name); // also NULL if the mixer runs another format; a file kept whole is decoded
+TTF_Font *archive_font(const Archive *archive, const char *name, int ptsize);
+Mix_Music *archive_music(const Archive *archive, const char *name); // a file kept whole, decoded as it plays
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef PACMAN_ASSETS_H
+#define PACMAN_ASSETS_H
+
+/* Assets that only some screens show. Each is registered once by name and
+ * loaded the first time a screen acquires it. A released asset stays cached
+ * until the cache needs room under its budget; then the least recently used
+ * unreferenced one is freed. Referenced assets are never evicted, so a screen
+ * can take the cache past its budget while it is shown.
+ *
+ * Long sounds are music: SDL_mixer decodes them while they play, from the
+ * loose file or from the archive mapping, and only its stream buffer is held. */
+
+#if defined(_WIN32) || defined(__APPLE__)
+#include <SDL.h>
+#include <SDL_mixer.h>
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include "archive.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ASSET_CACHE_MAX 16
+#define ASSET_CACHE_DEFAULT_BUDGET (16u << 20) // bytes, what --asset-budget MB overrides
+
+typedef enum {
+  ASSET_TEXTURE, // decoded RGBA, w * h * 4 bytes
+  ASSET_MUSIC    // streamed, held as a Mix_Music
+} AssetKind;
+
+typedef uint8_t AssetId;
+#define ASSET_NONE 0xFF // from asset_cache_add() once the cache is full; never loads
+
+typedef struct {
+  const char *name;  // under assets/, static string
+  AssetKind kind;
+  SDL_Texture *texture;
+  Mix_Music *music;
+  size_t bytes;      // while resident; 0 for music, which is not decoded up front
+  uint16_t refs;
+  uint32_t lastUse;  // cache clock at the last acquire
+  uint32_t loads;
+} Asset;
+
+typedef struct {
+  Asset assets[ASSET_CACHE_MAX];
+  uint8_t count;
+  size_t budget;
+  size_t resident, peak; // bytes of the loaded textures
+  uint32_t clock;
+  uint32_t evictions;
+  SDL_Renderer *renderer;
+  const Archive *archive; // tried first; the loose file otherwise
+  char dir[1024];         // the assets/ directory, separator included
+} AssetCache;
+
+void asset_cache_init(AssetCache *cache, SDL_Renderer *renderer, const Archive *archive, const char *dir, size_t budget);
+AssetId asset_cache_add(AssetCache *cache, const char *name, AssetKind kind); // registers only, nothing is loaded
+bool asset_cache_acquire(AssetCache *cache, AssetId id); // loads on first use; false if it cannot be loaded
+void asset_cache_release(AssetCache *cache, AssetId id); // cached until evicted
+SDL_Texture *asset_cache_texture(const AssetCache *cache, AssetId id); // NULL unless resident
+Mix_Music *asset_cache_music(const AssetCache *cache, AssetId id);
+void asset_cache_report(const AssetCache *cache); // every asset and the totals, on stdout
+void asset_cache_free(AssetCache *cache);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef PACMAN_BATCH_H
+#define PACMAN_BATCH_H
+
+/* Batched simulator: N independent games stored as structure-of-arrays and
+ * stepped together with the same rules as core_step(). Walls are shared
+ * through the Maze tables, so a game only owns its dot mask and a few scalars. */
+
+#include "core.h"
+
+#define BATCH_DOT_WORDS 4 // 64-bit words per game, the maze may hold up to 256 dots
+
+typedef struct {
+  const Maze *maze;
+  uint32_t count;
+  bool autoResume; // LIFE_LOST / START_LEVEL go straight back to PLAYING
+
+  // Pacman, one entry per game
+  int8_t *pacRow, *pacCol;
+  uint8_t *pacDir;
+  uint16_t *pacTimer;
+
+  // Ghosts, ghost-major: ghost g of game i lives at [g * count + i]
+  int8_t *ghostRow, *ghostCol;
+  uint8_t *ghostDir;
+  uint16_t *ghostTimer;
+  uint8_t *ghostScared;
+
+  // Per game scalars
+  int16_t *hunterTime;
+  uint16_t *score;
+  int8_t *lives;
+  uint8_t *dotsEaten;
+  uint8_t *rewardCount;
+  uint8_t *ghostCombo;
+  uint8_t *state;   // GameState
+  uint32_t *rng;
+  uint32_t *events; // CoreEvent mask of the last step
+
+  uint64_t *dotMask; // BATCH_DOT_WORDS per game, bit set = dot still there
+  uint8_t *due;      // scratch: entities whose move timer fires this tick
+  uint8_t *moved;    // scratch: games where a ghost changed tile this tick
+
+  void *block; // single allocation backing every array above
+} BatchSim;
+
+bool batch_init(BatchSim *sim, uint32_t count, uint32_t seed, bool autoResume); // game i is seeded with seed + i
+void batch_free(BatchSim *sim);
+void batch_init_game(BatchSim *sim, uint32_t game, uint32_t seed); // same as core_init()
+void batch_step(BatchSim *sim, const uint8_t *inputs);             // inputs[count] Directions or NULL
+void batch_get_game(const BatchSim *sim, uint32_t game, GameLogic *out);
+
+#endif
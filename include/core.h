@@ -0,0 +1,127 @@
+#ifndef PACMAN_CORE_H
+#define PACMAN_CORE_H
+
+/* Headless simulation core: everything needed to step a game without a
+ * window, renderer or audio device. No SDL header may be included here. */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "maze.h"
+#include "paths.h"
+
+// Core timers count thirds of a millisecond (CORE_MS() converts), so a 1/60 s
+// tick adds a whole DELTA_TICK = 50 to them. Ticks are paced TICK_RATE a
+// second and game time keeps up with real time. TARGET_FPS is only the frame
+// rate used when the display's is unknown.
+#define CORE_UNITS_PER_MS 3
+#define CORE_MS(ms) ((ms) * CORE_UNITS_PER_MS)
+#define TICK_RATE 60
+#define DELTA_TICK (CORE_MS(1000) / TICK_RATE)
+#define TARGET_FPS 60
+
+#define HUNTER_MODE_DURATION CORE_MS(10000)
+#define HUNTER_WARNING_TIME CORE_MS(3000)
+#define HUNTER_SCORE_MULTIPLIER 200
+
+extern const char pacman_map[MAP_ROWS][MAP_COLS];
+
+// ------------ DIRECTIONS -----------
+typedef enum { DIR_UP, DIR_LEFT, DIR_DOWN, DIR_RIGHT, DIR_COUNT } Direction;
+extern const int8_t directionOffsets[4][2];
+
+// ---- GAME ----
+typedef enum {
+  STATE_MENU,
+  STATE_PLAYING,
+  STATE_HELP,
+  STATE_PAUSED,
+  STATE_GAME_OVER,
+  STATE_GAME_COMPLETE,
+  STATE_START_LEVEL,
+  STATE_LIFE_LOST,
+  STATE_RANKING,
+  STATE_ENTER_NAME
+} GameState;
+
+typedef enum {
+  TYPE_PACMAN,
+  TYPE_BLINKY,
+  TYPE_PINKY,
+  TYPE_INKY,
+  TYPE_CLYDE
+} EntityKind;
+
+typedef struct {
+  EntityKind kind;
+  Direction dir;
+  uint16_t moveTimer;
+  int8_t row, col;
+  bool scared;
+} GameEntity;
+
+#define PACMAN_START_ROW 23
+#define PACMAN_START_COL 14
+#define BASE_TICKS CORE_MS(100) // pacman's move period
+#define MAX_LEVEL_DOTS 255 // dots and orbs of one board, as many as dotsEaten counts
+
+typedef struct {
+  GameEntity pacman;
+  uint16_t score;
+  int16_t hunterTime;  // CORE_MS() units left, HUNTER_MODE_DURATION fits
+  int8_t lives;
+  uint8_t dotsEaten;
+  uint8_t rewardCount;
+  uint8_t ghostCombo;
+} PlayerData;
+
+#define GHOST_HOME 14 // Row and Col are equals
+#define TUNNEL_ROW 14 // Classic board defaults; a Maze carries its own copy of these
+#define GHOST_FRIGHTENED_TICKS CORE_MS(150) // 150% OF BASE TICKS
+
+/*Speeds: based in pacman base ticks
+Blinky: 75% ; Pinky: 65% ; Inky: 55% ; Clyde : 45%
+*/
+extern const uint16_t ghostBaseTicks[4];
+
+// Things that happened during the last core_step(), as a bitmask.
+typedef enum {
+  CORE_EVENT_NONE           = 0,
+  CORE_EVENT_EAT_DOT        = 1 << 0,
+  CORE_EVENT_EAT_ORB        = 1 << 1,
+  CORE_EVENT_EAT_GHOST      = 1 << 2,
+  CORE_EVENT_SCORE          = 1 << 3,
+  CORE_EVENT_LIFE_LOST      = 1 << 4,
+  CORE_EVENT_GAME_OVER      = 1 << 5,
+  CORE_EVENT_LEVEL_COMPLETE = 1 << 6,
+  CORE_EVENT_GAME_COMPLETE  = 1 << 7,
+  CORE_EVENT_HUNTER_END     = 1 << 8
+} CoreEvent;
+
+typedef struct {
+  const Maze *maze;
+  const PathTable *paths; // built from maze; set after core_init() for path targeting, NULL keeps squared distance
+  uint64_t dots[MAZE_WORDS]; // dots and orbs still on the board
+  char map[MAP_ROWS][MAP_COLS]; // render/debug view of the board
+  PlayerData player;
+  GameEntity ghosts[4];
+  GameState state, prevState;
+  uint32_t events;
+  uint32_t rng;
+} GameLogic;
+
+void core_init(GameLogic *game, uint32_t seed);          // new game, left in STATE_START_LEVEL
+void core_init_level(GameLogic *game, bool levelWon);
+void core_reset_positions(GameLogic *game);
+void core_resume(GameLogic *game);                      // LIFE_LOST -> START_LEVEL -> PLAYING
+uint32_t core_step(GameLogic *game, Direction input);   // one DELTA_TICK tick, DIR_COUNT keeps pacman's direction
+uint32_t core_events(const GameLogic *game);
+uint16_t core_move_period(const GameLogic *game, const GameEntity *entity); // CORE_MS() units between moves right now, pacman or one of the ghosts
+bool core_same_state(const GameLogic *a, const GameLogic *b); // field by field, padding ignored
+
+/* Event-driven mode: jumps straight to the next tick on which a move timer or
+ * the hunter timer fires, and only runs core_step() there. Bit-identical to
+ * calling core_step() maxTicks times. Stops after the first tick whose events
+ * hit stopEvents or that leaves STATE_PLAYING. Returns the events seen. */
+uint32_t core_advance(GameLogic *game, uint32_t maxTicks, Direction input, uint32_t stopEvents, uint32_t *ticksDone);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef PACMAN_GLYPHS_H
+#define PACMAN_GLYPHS_H
+
+/* Glyph atlas: every printable ASCII glyph of one font, at each size the UI
+ * uses, rasterised once at startup into a single white texture. Text is then
+ * a row of quads in a SpriteBatch, tinted per label, so changing a label's
+ * text allocates, rasterises and uploads nothing. */
+
+#if defined(_WIN32) || defined(__APPLE__)
+#include <SDL_ttf.h>
+#else
+#include <SDL2/SDL_ttf.h>
+#endif
+
+#include "sprites.h"
+
+#define GLYPH_FIRST ' '
+#define GLYPH_LAST '~'
+#define GLYPH_COUNT (GLYPH_LAST - GLYPH_FIRST + 1)
+#define GLYPH_MAX_SIZES 4
+#define GLYPH_ATLAS_WIDTH 512
+
+typedef struct {
+  SDL_Texture *texture;
+  int sizeCount;
+  int height[GLYPH_MAX_SIZES];                // line height per size
+  SDL_Rect cell[GLYPH_MAX_SIZES][GLYPH_COUNT]; // atlas rect, its width is the advance
+} GlyphAtlas;
+
+// Leaves the font at the last size built. False on any TTF or SDL failure.
+bool glyph_atlas_build(GlyphAtlas *atlas, SDL_Renderer *renderer, TTF_Font *font, const uint8_t *sizes, int sizeCount);
+void glyph_atlas_free(GlyphAtlas *atlas);
+void glyph_text_size(const GlyphAtlas *atlas, int size, const char *text, int *w, int *h);
+void glyph_queue_text(const GlyphAtlas *atlas, SpriteBatch *batch, int size, const char *text, int x, int y, SDL_Color color);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef PACMAN_LEVEL_H
+#define PACMAN_LEVEL_H
+
+/* Baked levels. tools/mapc.c compiles a text maze (levels/NAME.txt) at build
+ * time into everything the game would otherwise derive at startup: the Maze
+ * tables with spawns and tunnel row, and the wall art rects. The .lvl file
+ * is the Level struct itself, so loading is one fread plus a header check.
+ * It is tied to the build that wrote it (struct layout, endianness,
+ * MAP_ROWS x MAP_COLS); the header rejects anything else. */
+
+#include <stddef.h>
+#include "core.h"
+
+#define LEVEL_MAGIC 0x4C434150u // "PACL" read as a little endian uint32_t
+#define LEVEL_VERSION 1
+#define LEVEL_ART_TILE 8        // spritesheet pixels per tile, TILE_SPR_SIZE on the SDL side
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t bytes;      // sizeof(Level) of the writer
+  uint16_t rows, cols; // MAP_ROWS, MAP_COLS of the writer
+} LevelHeader;
+
+typedef struct {
+  LevelHeader header;
+  Maze maze;                       // ready for GameLogic.maze
+  uint16_t wallSrc[MAZE_TILES][2]; // spritesheet x, y of the wall art for each tile
+} Level;
+
+/* Text format, one directive per line, '#' only starts a comment before "map":
+ *   pacman ROW COL      ghost ROW COL (x4: Blinky, Pinky, Inky, Clyde)
+ *   home ROW COL        tunnel ROW        walls X Y (wall art origin, optional)
+ *   map                 then MAP_ROWS rows of '#', '.', 'o' and ' ', short rows padded with spaces
+ * Returns false with a message in error on any malformed or unplayable input. */
+bool level_compile(Level *level, const char *text, char *error, size_t errorSize);
+bool level_save(const Level *level, const char *path);
+bool level_load(Level *level, const char *path); // false on I/O error, a file from another build or spawns off the board
+
+#endif
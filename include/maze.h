@@ -0,0 +1,79 @@
+#ifndef PACMAN_MAZE_H
+#define PACMAN_MAZE_H
+
+/* Maze tables built once from a char map: wall/dot/orb bitboards, a 4-bit
+ * legal move mask and a neighbour index per tile, plus where everyone
+ * starts. Movement, dot counting and tunnel wrapping become lookups; the
+ * char map is only a view. Plain arrays only, so a built Maze can be baked
+ * to disk and read back as is (see level.h). */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MAP_ROWS 31
+#define MAP_COLS 29
+
+#define MAZE_TILES (MAP_ROWS * MAP_COLS)
+#define MAZE_WORDS ((MAZE_TILES + 63) / 64)
+
+typedef struct {
+  uint64_t walls[MAZE_WORDS];
+  uint64_t dots[MAZE_WORDS];   // every tile that starts with a '.' or an 'o'
+  uint64_t orbs[MAZE_WORDS];   // the 'o' subset of dots
+  uint8_t moveMask[MAZE_TILES];  // bit d: core_try_move() in direction d succeeds, tunnel included
+  uint8_t chaseMask[MAZE_TILES]; // bit d: ghosts may score direction d (in bounds, no wrap, not a wall)
+  uint16_t neighbour[MAZE_TILES][4]; // destination tile of a move, valid where moveMask is set
+  uint8_t tileRow[MAZE_TILES], tileCol[MAZE_TILES];
+  uint16_t dotCount;
+
+  char map[MAP_ROWS][MAP_COLS]; // the source map, copied into each game as its render view
+  int8_t tunnelRow;             // leaving a side of the board lands on this row
+  int8_t pacmanStart[2];        // row, col
+  int8_t ghostStart[4][2];      // Blinky, Pinky, Inky, Clyde
+  int8_t ghostHome[2];          // where eaten ghosts are sent back
+} Maze;
+
+// Spawns get the classic positions, callers with other maps override them.
+void maze_build(Maze *maze, const char map[MAP_ROWS][MAP_COLS], int8_t tunnelRow);
+const Maze *maze_default(void); // pacman_map, built on first use
+
+static inline uint16_t maze_tile(int8_t row, int8_t col) {
+    return (uint16_t)(row * MAP_COLS + col);
+}
+
+static inline bool bitboard_test(const uint64_t *bb, uint16_t tile) {
+    return (bb[tile >> 6] >> (tile & 63)) & 1;
+}
+
+static inline void bitboard_set(uint64_t *bb, uint16_t tile) {
+    bb[tile >> 6] |= 1ull << (tile & 63);
+}
+
+static inline void bitboard_clear(uint64_t *bb, uint16_t tile) {
+    bb[tile >> 6] &= ~(1ull << (tile & 63));
+}
+
+static inline int bitboard_popcount64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+static inline int bitboard_count(const uint64_t *bb, int words) {
+    int count = 0;
+    for (int i = 0; i < words; i++) count += bitboard_popcount64(bb[i]);
+    return count;
+}
+
+static inline bool bitboard_empty(const uint64_t *bb, int words) {
+    uint64_t any = 0;
+    for (int i = 0; i < words; i++) any |= bb[i];
+    return any == 0;
+}
+
+#endif
@@ -33,59 +33,27 @@
 #endif
 
 #include "rank.h"
+#include "core.h"
+#include "world.h"
+#include "level.h"
+#include "sprites.h"
+#include "glyphs.h"
+#include "timeline.h"
+#include "scheduler.h"
+#include "simthread.h"
+#include "archive.h"
+#include "startup.h"
+#include "assets.h"
+#include "softframe.h"
 
 #define WINDOW_WIDTH 464
 #define WINDOW_HEIGHT 600
 
-#define MAP_ROWS 31
-#define MAP_COLS 29
 #define TILE_WIN_SIZE 16 
 #define TILE_SPR_SIZE 8
 
 #define MAP_OFFSET_Y 52
 
-#define TOTAL_DOTS 244
-#define HUNTER_MODE_DURATION_MS 10000
-#define HUNTER_WARNING_TIME_MS 3000
-#define HUNTER_SCORE_MULTIPLIER 200
-
-#define TARGET_FPS 60
-#define DELTA_TICK_MS (1000 / TARGET_FPS)
-
-const char pacman_map[MAP_ROWS][MAP_COLS] = {
-"############################",
-"#............##............#",
-"#.####.#####.##.#####.####.#",
-"#o#  #.#   #.##.#   #.#  #o#",
-"#.####.#####.##.#####.####.#",
-"#..........................#",
-"#.####.##.########.##.####.#",
-"#.####.##.########.##.####.#",
-"#......##....##....##......#",
-"######.##### ## #####.######",
-"######.##### ## #####.######",
-"######.##          ##.######",
-"######.## ###  ### ##.######",
-"######.## ##    ## ##.######",
-"      .   ########   .      ",
-"######.## ######## ##.######",
-"######.## ######## ##.######",
-"######.##          ##.######",
-"######.## ######## ##.######",
-"######.## ######## ##.######",
-"#............##............#",
-"#.####.#####.##.#####.####.#",
-"#.####.#####.##.#####.####.#",
-"#o..##.......  .......##..o#",
-"###.##.##.########.##.##.###",
-"###.##.##.########.##.##.###",
-"#......##....##....##......#",
-"#.##########.##.##########.#",
-"#.##########.##.##########.#",
-"#..........................#",
-"############################"
-};
-
 typedef enum {
   // Pacman animado
   SPR_PACMAN_UP_1,
@@ -139,65 +107,16 @@ typedef enum {
   SPR_NULL
 } SpriteID;
 
-const SDL_Rect spriteClips[37] = {
-  // Pacman
-  {456, 32, 16, 16},  {472, 32, 16, 16},    // up
-  {456, 16, 16, 16}, {472, 16, 16, 16},   // left
-  {456, 48, 16, 16},  {472, 48, 16, 16},    // down
-  {456, 0, 16, 16}, {472, 0, 16, 16},   // right
-  {504,0,16,16}, // Pacman lose start
-
-  // Ghosts
-  {456, 64, 16, 16},   {472, 64, 16, 16},   // Red
-  {456, 80, 16, 16}, {472, 80, 16, 16},   // Pink
-  {456, 96, 16, 16}, {472, 96, 16, 16},   // Light Blue
-  {456, 112, 16, 16}, {472, 112, 16, 16},   // Orange
-
-  // eyes , these are render alone 
-   {584, 80, 16, 16},
-   {600, 80, 16, 16},
-  {632, 80, 16, 16},
-   {616, 80, 16, 16},
-
-  // Scary pacmans.
-{584, 64, 16, 16},
-{600, 64, 16, 16},
-{616, 64, 16, 16},
-{632, 64, 16, 16},
-
-    //Rewards
-{504,48,16,16},
-{520,48,16,16},
-{536,48,16,16},
-{552,48,16,16},
-{568,48,16,16},
-{584,48,16,16},
-{600,48,16,16},
-{616,48,16,16},
-
-  // Points
-  {8, 8, 8, 8},     // '.'
-  {8, 24, 8, 8},    // 'o'
-
-{0,88, 8, 8},   // Empty ' '
-{0,0,0,0}   // NULL
-};
-
-const SDL_Color colors[3] ={
-  {255,255,255,255},
-  {0,0,0,255},
-  {150, 150, 150, 255},
-};
-
 typedef enum {WHITE,BLACK,GREY} FontColor;
 
 typedef enum {STANDARD,SMALL} FontSize;
-const uint8_t fontSizes[2] = {24,12}; 
 
+// Drawn from the glyph atlas; dst.w and dst.h follow the text after layout_text()
 typedef struct {
   SDL_Rect dst;
   char *text;
-  SDL_Texture *texture;
+  FontSize size;
+  FontColor color;
   bool needsUpdate;
 } TextLabel;
 
@@ -206,82 +125,13 @@ typedef struct {
   SDL_Texture *img;
 } SpriteImage;
 
-
-// ------------ DIRECTIONS -----------
-typedef enum { DIR_UP, DIR_LEFT, DIR_DOWN, DIR_RIGHT, DIR_COUNT } Direction;
-const int8_t directionOffsets[4][2] = {
-  {-1, 0}, {0, -1}, {1, 0}, {0, 1}
-};
-// ---- GAME ----
-typedef enum {
-  STATE_MENU,
-  STATE_PLAYING,
-  STATE_HELP,
-  STATE_PAUSED,
-  STATE_GAME_OVER,
-  STATE_GAME_COMPLETE,
-  STATE_START_LEVEL,
-  STATE_LIFE_LOST,
-  STATE_RANKING,
-  STATE_ENTER_NAME
-} GameState;
-
-typedef enum {
-  TYPE_PACMAN,
-  TYPE_BLINKY,
-  TYPE_PINKY,
-  TYPE_INKY,
-  TYPE_CLYDE
-} EntityKind;
-
-typedef struct {
-  EntityKind kind;
-  Direction dir;
-  u_int16_t moveTimer;
-  int8_t row, col;
-  bool scared;
-} GameEntity;
-
-#define PACMAN_START_ROW 23
-#define PACMAN_START_COL 14
-#define BASE_TICKS 100
-
-typedef struct {
-  TextLabel playerName;
-  GameEntity pacman;
-  uint16_t score;
-  int16_t hunterTime;  
-  int8_t lives;
-  uint8_t dotsEaten;
-  uint8_t rewardCount;
-  uint8_t ghostCombo;
-} PlayerData;
-
-#define GHOST_HOME 14 // Row and Col are equals
-#define GHOST_FRIGHTENED_TICKS 150 // 150% OF BASE TICKS 
-
-/*Speeds: based in pacman base ticks
-Blinky: 75% ; Pinky: 65% ; Inky: 55% ; Clyde : 45%
-*/
-const uint8_t ghostBaseTicks[4] = {
-    (uint8_t)(BASE_TICKS*1.25), 
-    (uint8_t)(BASE_TICKS*1.35),
-    (uint8_t)(BASE_TICKS*1.45),
-    (uint8_t)(BASE_TICKS*1.55)
-};
-
-typedef struct {
-  char map[MAP_ROWS][MAP_COLS];
-  ScoreBoard board;
-  PlayerData player;
-  GameEntity ghosts[4];
-  GameState state, prevState;
-} GameLogic;
-
 typedef struct {
   uint32_t lastTicks;
-  uint32_t startPauseTicks;
-  int32_t accumulator;
+  uint32_t frameMs;    // length of the last main loop iteration
+  Scheduler ticks;     // simulation ticks, DELTA_TICK apart
+  Scheduler frames;    // presents at the display refresh rate, used when vsync is off
+  bool vsync;          // present already waits for the display
+  Timeline transition; // death animation, countdown, game over and win screens
 } GameClock;
 
 typedef struct {
@@ -290,7 +140,6 @@ typedef struct {
   Mix_Chunk *death;
   Mix_Chunk *start;
   Mix_Chunk *move;
-  Mix_Chunk *win;
   uint16_t dotTimer,moveTimer;
 } GameSounds;
 
@@ -313,6 +162,7 @@ typedef struct {
 
 typedef struct {
   TextLabel hint, names, scores;
+  TextLabel playerName;
   SpriteImage rankingImg;
 } ScoreboardLayout;
 
@@ -323,8 +173,53 @@ typedef struct {
   HelpLayout help;
 } UILayout;
 
+// Walls and dots drawn once per level into a render target, eaten tiles are patched in
+#define MAZE_LAYER_PATCHES 16
+typedef struct {
+  SDL_Texture *texture;  // NULL without render target support: tiles are drawn every frame
+  bool rebuild;          // new level or lost render targets
+  uint8_t patchCount;
+  uint16_t patches[MAZE_LAYER_PATCHES]; // maze tiles eaten since the last frame
+} MazeLayer;
+
+// Frames are drawn between sim ticks: each entity slides from the tile it left
+// on its last move to the one it is on, as far as its move timer has run.
+#define MOTION_PACMAN 4
+typedef struct {
+  int8_t row[5], col[5]; // tile before the last move, ghosts 0-3 then pacman
+  float alpha;           // fraction of the next tick already elapsed, frozen outside gameplay
+} MotionState;
+
+// --stats: frame counters, reported on stdout once a second
+typedef struct {
+  bool enabled;
+  uint32_t lastReport;
+  uint32_t frames;    // presents since the last report
+  uint32_t drawCalls; // render calls since the last report
+  uint32_t wakeups;   // main loop iterations since the last report
+  clock_t lastCpu;    // process CPU time at the last report, all threads
+} RenderStats;
+
+// Images and sounds of the screens seen a few seconds per session, if at all:
+// held while their screen is shown, cached under a budget after. Registered in
+// this order, so each is its own AssetId.
+typedef enum {
+  SCREEN_HELP,
+  SCREEN_RANKING,
+  SCREEN_PAUSE,
+  SCREEN_GAME_OVER,
+  SCREEN_GAME_WIN,
+  SCREEN_WIN_SOUND, // streamed
+  SCREEN_ASSET_COUNT
+} ScreenAsset;
+
+// Static screens block for events instead of looping; the wait still ends this
+// often so --stats keeps reporting.
+#define IDLE_WAKE_MS 1000
+
 typedef struct {
   GameLogic game;
+  ScoreBoard board;
   UILayout ui;
   SDL_Event event;
   GameSounds sounds;
@@ -334,15 +229,36 @@ typedef struct {
   SDL_Renderer *renderer;
   TTF_Font *font;
   SDL_Texture *spritesheet;
-
+  Archive assets;      // assets.pak, mapped for the whole run; closed: loose files under assets/
+  AssetCache screenAssets; // ScreenAsset ids
+  uint8_t heldAssets;       // ScreenAsset bits the current screen holds
+  MazeLayer mazeLayer;
+  SoftFrame soft;      // --soft: frames built in the window surface, surface NULL otherwise
+  SpriteBatch sprites; // spritesheet quads for the frame, one submission
+  GlyphAtlas glyphs;
+  SpriteBatch text;    // glyph quads, drawn over everything else at present
+  RenderStats stats;
+  MotionState motion;
+  StartupLog startup; // stage timings, printed after the first frame with --stats
+  SDL_Thread *workers[4]; // startup jobs not joined yet, waited for before any error exit
+
+  SimThread *sim;  // --threaded: ticks run on their own thread, NULL steps them in the main loop
+  bool simPlaying; // the sim thread owns game, app->game is a copy of its latest snapshot
+  Scheduler simClock; // sim clock of the latest snapshot
+  uint32_t simEvents[SIM_EVENT_BITS]; // event counts of the latest snapshot
+
+  World *world;    // --world mode: a generated maze replaces the classic board, NULL otherwise
+  const Level *level; // --level: baked board and wall art, NULL for the built-in classic board
+  Direction input; // pending pacman direction for the next core_step(), DIR_COUNT if none
+  bool needsRedraw; // the window lost its pixels, static screens draw again on the next render()
   bool isRunning;
 } AppContext;
 
-void init_game_application(AppContext *app);
+void init_game_application(AppContext *app, bool soft); // soft: the --soft backend instead of SDL_CreateRenderer()
 void quit_game_application(AppContext *app);
 void handle_events(AppContext *app);
 void render(AppContext *app); 
-void update_game(AppContext *app);  // -> move ghosts , pacman and checks colisions
+void update_game(AppContext *app, uint32_t ticks);  // -> runs that many core_step() ticks and reacts to their events
 
 
 #endif
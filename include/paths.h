@@ -0,0 +1,40 @@
+#ifndef PACMAN_PATHS_H
+#define PACMAN_PATHS_H
+
+/* All-pairs shortest path lengths over the reachable tiles of a Maze, moving
+ * like core_try_move() does (tunnel wrap included). Stored as one uint8_t per pair,
+ * one row per destination: a ghost weighing its candidate moves towards a
+ * target reads neighbouring bytes of the same row. */
+
+#include "maze.h"
+
+#define PATHS_FAR 0xFF // unreachable, or 255+ steps away
+#define PATHS_NO_INDEX 0xFFFF
+
+typedef struct {
+  const Maze *maze;
+  uint16_t count;                // reachable tiles
+  uint16_t tileIndex[MAZE_TILES]; // tile -> index, PATHS_NO_INDEX if unreachable
+  uint16_t nearest[MAZE_TILES];   // tile -> index of the closest reachable tile, for targets inside walls
+  uint8_t *steps;                // steps[to * count + from]
+} PathTable;
+
+// Only tiles reachable from (startRow, startCol) get an index. False when out of memory.
+bool paths_build(PathTable *paths, const Maze *maze, int8_t startRow, int8_t startCol);
+void paths_free(PathTable *paths);
+const PathTable *paths_default(void); // maze_default() from Pacman's start tile, NULL when out of memory
+
+// Any (row, col) target, even off the board, snapped to a reachable tile.
+static inline uint16_t paths_target(const PathTable *paths, int row, int col) {
+    if (row < 0) row = 0;
+    if (row >= MAP_ROWS) row = MAP_ROWS - 1;
+    if (col < 0) col = 0;
+    if (col >= MAP_COLS) col = MAP_COLS - 1;
+    return paths->nearest[maze_tile(row, col)];
+}
+
+static inline uint8_t paths_steps(const PathTable *paths, uint16_t fromIndex, uint16_t toIndex) {
+    return paths->steps[(uint32_t)toIndex * paths->count + fromIndex];
+}
+
+#endif
@@ -7,7 +7,9 @@
 
 #define MAX_NAME_LEN 8
 #define MAX_SCORES 10
-#define SCORE_FILE "scores.bin"
+#ifndef SCORE_FILE
+#define SCORE_FILE "scores.bin" // next to the binary; the benches build rank.c with their own
+#endif
 
 typedef struct {
     char name[MAX_NAME_LEN+1];
@@ -0,0 +1,49 @@
+#ifndef PACMAN_SCHEDULER_H
+#define PACMAN_SCHEDULER_H
+
+/* Fixed-timestep scheduler on the high resolution performance counter.
+ * A tick lasts num / den seconds, so tick n is due at exactly
+ * start + n * freq * num / den counter units: the remainder of the division
+ * is carried, so 16 ms really is 16 ms (and 1/60 s is 1/60 s) and no error
+ * builds up over time. Catch-up after a stall is bounded, the rest of the
+ * backlog is dropped and counted, so a slow frame cannot snowball into a
+ * slower one. scheduler_wait() sleeps most of the way to the next deadline
+ * and spins the last stretch, which SDL_Delay() is too coarse for. */
+
+#if defined(_WIN32) || defined(__APPLE__)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SCHEDULER_MAX_CATCH_UP 5  // ticks run in one frame before the backlog is dropped
+#define SCHEDULER_SPIN_US 2000    // spun instead of slept before a deadline
+
+typedef struct {
+  uint64_t freq;           // counter units per second
+  uint32_t num, den;       // a tick every num / den seconds
+  uint64_t step;           // freq * num / den
+  uint32_t stepRem, carry; // freq * num % den, and how much of it is owed to the next deadline
+  uint64_t next;           // counter value the next tick is due at
+  uint64_t spin;
+
+  // Counters: totals since init, and the worst and summed lateness since the last report
+  uint64_t ticks, dropped;
+  uint64_t lateMax, lateSum;
+  uint32_t lateCount;
+} Scheduler;
+
+void scheduler_init(Scheduler *scheduler, uint32_t num, uint32_t den); // ticks num / den seconds apart
+uint32_t scheduler_due(Scheduler *scheduler); // ticks to run now, at most SCHEDULER_MAX_CATCH_UP
+void scheduler_wait(Scheduler *scheduler);    // until the next tick is due
+void scheduler_resync(Scheduler *scheduler);  // restart the deadlines from now after a deliberate sleep, nothing is owed
+float scheduler_alpha(const Scheduler *scheduler); // how far the clock is into the next tick, 0..1
+
+static inline double scheduler_ms(const Scheduler *scheduler, uint64_t counts) {
+    return counts * 1000.0 / scheduler->freq;
+}
+
+#endif
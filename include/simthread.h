@@ -0,0 +1,67 @@
+#ifndef PACMAN_SIMTHREAD_H
+#define PACMAN_SIMTHREAD_H
+
+/* --threaded: GameLogic steps on its own thread, TICK_RATE ticks a second, while the main
+ * thread handles events, renders and presents, so a stalled present no longer
+ * delays ticks and a burst of ticks no longer delays a frame.
+ *
+ * Ownership of the game is handed over, never shared. The main thread starts
+ * a session with sim_thread_play() once the game is PLAYING; from then on only
+ * the sim thread writes it. Each batch of ticks is published as a snapshot
+ * through a triple buffer: the writer always has a free slot, the reader
+ * always gets the newest complete one, and neither waits on the other.
+ * Directions reach the sim through a single producer, single consumer ring.
+ * The session ends when a tick leaves PLAYING (life lost, game over, win) or
+ * when the main thread calls sim_thread_stop(); the last snapshot is always
+ * published before ownership comes back. */
+
+#if defined(_WIN32) || defined(__APPLE__)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+#include "core.h"
+#include "scheduler.h"
+
+#define SIM_EVENT_BITS 9   // CoreEvent bits, CORE_EVENT_EAT_DOT to CORE_EVENT_HUNTER_END
+#define SIM_INPUT_SLOTS 64 // power of two
+
+typedef struct {
+  GameLogic game;
+  Scheduler clock;                    // the sim clock when published, for interpolating between ticks
+  uint32_t eventCounts[SIM_EVENT_BITS]; // times each CoreEvent bit fired since the thread started
+} SimSnapshot;
+
+typedef struct {
+  SDL_Thread *thread;
+  uint32_t tickRate;
+  SDL_atomic_t quit;
+  SDL_atomic_t session; // 0 main thread owns the game, 1 sim thread does, 2 main asked for it back
+  SDL_sem *wake;        // posted on play and quit, the thread sleeps on it between sessions
+
+  // Triple buffer: latest is a slot index, with SIM_SLOT_FRESH set until the reader takes it
+  SimSnapshot slots[3];
+  SDL_atomic_t latest;
+  int back;  // sim thread only
+  int front; // main thread only
+
+  // Input ring: head is written by the main thread, tail by the sim thread
+  // (and by sim_thread_play() between sessions, when the sim thread is idle)
+  uint8_t input[SIM_INPUT_SLOTS];
+  SDL_atomic_t head, tail;
+
+  // Sim thread only
+  GameLogic game;
+  Scheduler clock;
+  uint32_t eventCounts[SIM_EVENT_BITS];
+} SimThread;
+
+bool sim_thread_start(SimThread *sim, uint32_t tickRate); // ticks a second, false if the thread could not be created
+void sim_thread_quit(SimThread *sim);
+void sim_thread_play(SimThread *sim, const GameLogic *game); // hands a PLAYING game to the sim thread
+void sim_thread_stop(SimThread *sim);                  // takes it back, the final snapshot is left to read
+bool sim_thread_input(SimThread *sim, Direction dir);  // false when the ring is full
+const SimSnapshot *sim_thread_latest(SimThread *sim);  // newest unread snapshot, NULL if none; valid until the next call
+
+#endif
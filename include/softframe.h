@@ -0,0 +1,55 @@
+#ifndef PACMAN_SOFTFRAME_H
+#define PACMAN_SOFTFRAME_H
+
+/* Software backend (--soft), for machines without a GPU. Frames are built in
+ * the window surface itself: the board background lives in a surface of the
+ * same format, built from the sprite atlas with 2x cell blits and copied
+ * back only where something covered it last frame; sprites, text and images
+ * are drawn over it by SDL's software renderer, targeting that same window
+ * surface. Present pushes just the changed rects to the window. Frames that
+ * do not start from the board (menus, the generated world) push everything. */
+
+#if defined(_WIN32) || defined(__APPLE__)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SOFT_CELL 8          // atlas cell side soft_blit_cell() doubles with SIMD, TILE_SPR_SIZE on the game side
+#define SOFT_RECTS_MAX 128   // per list; past that the frame is pushed whole
+
+typedef struct {
+  SDL_Window *window;
+  SDL_Surface *surface;  // the window's, what the software renderer draws into
+  SDL_Surface *sheet;    // sprite atlas in the surface's pixel format
+  SDL_Surface *board;    // background of the board, in window coordinates at boardDst
+  SDL_Rect boardDst;
+  SDL_Rect drawn[SOFT_RECTS_MAX]; // covered this frame
+  SDL_Rect shown[SOFT_RECTS_MAX]; // covered last frame: the background goes back there first
+  SDL_Rect dirty[SOFT_RECTS_MAX]; // background changed under them this frame
+  int drawnCount, shownCount, dirtyCount;
+  bool full;             // redraw the background and push the whole surface
+  bool restored;         // this frame started from the board background
+  bool boardShown;       // the last frame did, and drawn held all it covered
+  bool untracked;        // something drawn this frame is missing from drawn
+  uint32_t pushed;       // pixels sent to the window, for --stats
+} SoftFrame;
+
+bool soft_frame_init(SoftFrame *soft, SDL_Window *window); // false without a window surface
+bool soft_frame_sheet(SoftFrame *soft, SDL_Surface *pixels); // keeps a converted copy
+bool soft_frame_board(SoftFrame *soft, const SDL_Rect *dst); // allocates the background at dst, black
+void soft_frame_free(SoftFrame *soft);
+
+// One atlas cell into dst at dstRect, inside dst's clip rect. An SOFT_CELL cell
+// doubled to 2 * SOFT_CELL takes the SIMD path; other sizes go through SDL.
+void soft_blit_cell(SDL_Surface *dst, const SDL_Surface *sheet, const SDL_Rect *cell, const SDL_Rect *dstRect);
+
+void soft_frame_mark(SoftFrame *soft, const SDL_Rect *rect);  // drawn over the background; NULL is everything
+void soft_frame_dirty(SoftFrame *soft, const SDL_Rect *rect); // background changed, in window coordinates
+void soft_frame_restore(SoftFrame *soft); // starts a board frame: background back where last frame drew
+void soft_frame_present(SoftFrame *soft, SDL_Renderer *renderer); // finishes the renderer's work and pushes
+
+#endif
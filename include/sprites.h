@@ -0,0 +1,41 @@
+#ifndef PACMAN_SPRITES_H
+#define PACMAN_SPRITES_H
+
+/* Sprite batch: textured quads from one texture are queued as plain rects
+ * and submitted together with a single SDL_RenderGeometry() call, instead
+ * of one SDL_RenderCopy() each. The software and low-end renderers pay per
+ * call, not per quad. Builds against SDL older than 2.0.18, or renderers
+ * that refuse geometry, fall back to one copy per quad. */
+
+#if defined(_WIN32) || defined(__APPLE__)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SPRITE_BATCH_MAX 512 // quads per submission, a full batch is flushed on its own
+
+typedef struct {
+  SDL_Renderer *renderer;
+  SDL_Texture *texture;
+  float texelW, texelH;  // 1 / texture size, src rects -> uv
+  bool noGeometry;       // renderer refused SDL_RenderGeometry once, copy from now on
+  int count;
+  SDL_Rect src[SPRITE_BATCH_MAX], dst[SPRITE_BATCH_MAX];
+  SDL_Color tint[SPRITE_BATCH_MAX];
+  SDL_Vertex vertices[SPRITE_BATCH_MAX * 4];
+  int indices[SPRITE_BATCH_MAX * 6]; // fixed two-triangle pattern, filled once
+  uint32_t *drawCalls;   // bumped on every submission, may be NULL
+  void (*onSubmit)(void *context, const SDL_Rect *dst, int count); // sees each submission's dst rects, may be NULL
+  void *onSubmitContext;
+} SpriteBatch;
+
+void sprite_batch_init(SpriteBatch *batch, SDL_Renderer *renderer, SDL_Texture *texture, uint32_t *drawCalls);
+void sprite_batch_add(SpriteBatch *batch, const SDL_Rect *src, const SDL_Rect *dst);
+void sprite_batch_add_tinted(SpriteBatch *batch, const SDL_Rect *src, const SDL_Rect *dst, SDL_Color tint); // texels times tint
+void sprite_batch_flush(SpriteBatch *batch); // draws everything queued, in order
+
+#endif
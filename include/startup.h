@@ -0,0 +1,38 @@
+#ifndef PACMAN_STARTUP_H
+#define PACMAN_STARTUP_H
+
+/* Startup timeline: every stage of init_game_application(), on whichever
+ * thread ran it, with its start and length relative to the first stage.
+ * Printed with --stats once the first frame is on screen. Slots are claimed with an atomic
+ * add, so worker threads log without taking a lock. */
+
+#if defined(_WIN32) || defined(__APPLE__)
+#include <SDL.h>
+#else
+#include <SDL2/SDL.h>
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define STARTUP_MAX_STAGES 32
+
+typedef struct {
+  const char *name;   // static string
+  const char *thread; // "main" or the worker's name
+  uint64_t start, end;
+} StartupStage;
+
+typedef struct {
+  uint64_t begin;     // performance counter at startup_begin()
+  SDL_atomic_t count;
+  StartupStage stages[STARTUP_MAX_STAGES];
+  bool printed;
+} StartupLog;
+
+void startup_begin(StartupLog *log);
+int startup_stage_begin(StartupLog *log, const char *name, const char *thread); // -1 once the log is full
+void startup_stage_end(StartupLog *log, int stage);
+void startup_print(StartupLog *log, const char *milestone); // stages in start order, then the time to milestone; once
+
+#endif
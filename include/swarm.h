@@ -0,0 +1,49 @@
+#ifndef PACMAN_SWARM_H
+#define PACMAN_SWARM_H
+
+/* Mass-ghost stress mode: one game with any number of ghosts, for
+ * load-testing the engine. Ghosts are structure-of-arrays, collisions go
+ * through a per-tile occupancy list instead of a scan over every ghost, and
+ * chasing ghosts all read one BFS flow field from Pacman, rebuilt when he
+ * changes tile. Pacman, dots, orbs and hunter mode follow core_step(). */
+
+#include "core.h"
+
+#define SWARM_NONE UINT32_MAX
+#define SWARM_SPAWN_DISTANCE 8 // ghosts spawn at least this many steps from Pacman's start
+
+typedef struct {
+  const Maze *maze;
+  uint32_t ghostCount;
+
+  PlayerData player;
+  uint64_t dots[MAZE_WORDS];
+  GameState state; // LIFE_LOST, GAME_OVER and GAME_COMPLETE restart on their own
+  uint32_t events; // CoreEvent mask of the last step
+  uint32_t rng;
+  uint32_t flowBuilds; // flow field rebuilds so far
+
+  // Ghosts
+  uint16_t *ghostTile, *ghostSpawn;
+  uint16_t spareSpawn[2]; // two distinct spawn tiles, for an eaten ghost whose own is under Pacman
+  uint16_t *ghostTimer;
+  uint8_t *ghostDir, *ghostScared;
+  uint32_t *ghostNext, *ghostPrev; // occupancy list links
+
+  uint32_t tileHead[MAZE_TILES]; // first ghost on each tile, SWARM_NONE when empty
+  uint8_t flow[MAZE_TILES];      // steps to Pacman, PATHS_FAR when he cannot be reached
+  uint16_t flowTile;             // Pacman's tile when flow was built
+
+  // Reverse move graph, to run the BFS from Pacman outwards
+  uint16_t predStart[MAZE_TILES + 1];
+  uint16_t pred[MAZE_TILES * 4];
+
+  void *block; // single allocation backing the ghost arrays
+} Swarm;
+
+bool swarm_init(Swarm *swarm, uint32_t ghostCount, uint32_t seed); // false when out of memory or the maze has no room
+void swarm_free(Swarm *swarm);
+void swarm_new_game(Swarm *swarm);
+uint32_t swarm_step(Swarm *swarm, Direction input); // one DELTA_TICK tick, DIR_COUNT keeps pacman's direction
+
+#endif
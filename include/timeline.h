@@ -0,0 +1,26 @@
+#ifndef PACMAN_TIMELINE_H
+#define PACMAN_TIMELINE_H
+
+/* Frame-driven timeline for transitional screens: the main loop feeds it the
+ * time each frame took and the screen asks which step it is on, instead of
+ * sleeping through the animation with the event loop frozen. */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+  uint32_t elapsedMs;
+  uint32_t stepMs;     // length of one animation frame or countdown step
+  uint16_t steps;
+  bool done;
+} Timeline;
+
+void timeline_start(Timeline *timeline, uint16_t steps, uint32_t stepMs);
+bool timeline_advance(Timeline *timeline, uint32_t deltaMs); // true once, on the frame it ends
+
+static inline uint16_t timeline_step(const Timeline *timeline) { // 0 .. steps-1
+    uint32_t step = timeline->elapsedMs / timeline->stepMs;
+    return step < timeline->steps ? (uint16_t)step : timeline->steps - 1;
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef PACMAN_WORLD_H
+#define PACMAN_WORLD_H
+
+/* Large procedurally generated mazes, sized at runtime. Every wall is a pure
+ * function of (seed, row, col), so the world is stored as 32x32 chunks that
+ * are only generated the first time something looks at them: memory and
+ * per-frame work follow what Pacman visits and sees, not the maze size. */
+
+#include "core.h"
+
+#define WORLD_CHUNK 32        // tiles per chunk side, one uint32_t per chunk row
+#define WORLD_MIN_SIDE 5
+#define WORLD_MAX_SIDE 4095
+
+typedef struct {
+  uint32_t walls[WORLD_CHUNK]; // bit c of walls[r]: tile (r, c) of the chunk is a wall
+  uint32_t dots[WORLD_CHUNK];  // dots still on the board
+} WorldChunk;
+
+typedef struct {
+  uint32_t seed;
+  int32_t rows, cols;           // tiles, always odd
+  int32_t chunkRows, chunkCols;
+  WorldChunk **chunks;          // chunkRows * chunkCols, NULL until first touched
+  uint32_t chunksBuilt;
+
+  // Pacman exploring the world
+  int32_t pacRow, pacCol;
+  Direction pacDir;
+  uint16_t pacTimer;
+  uint32_t score, dotsEaten;
+  uint32_t events; // CoreEvent mask of the last step
+} World;
+
+// Tiles visible through a viewRows x viewCols window centred on Pacman, clamped to the world.
+typedef struct {
+  int32_t firstRow, firstCol;   // top-left tile of the camera
+  int32_t lastRow, lastCol;     // last tile that shows, inclusive
+  int32_t firstChunkRow, firstChunkCol, lastChunkRow, lastChunkCol;
+} WorldView;
+
+// Sizes are clamped to [WORLD_MIN_SIDE, WORLD_MAX_SIDE] and made odd. False when out of memory.
+bool world_init(World *world, int32_t rows, int32_t cols, uint32_t seed);
+void world_free(World *world);
+WorldChunk *world_chunk(World *world, int32_t chunkRow, int32_t chunkCol); // generated on first use, NULL when out of memory
+bool world_is_wall(World *world, int32_t row, int32_t col);
+uint32_t world_step(World *world, Direction input); // one DELTA_TICK tick, DIR_COUNT keeps pacman's direction
+void world_view(const World *world, int32_t viewRows, int32_t viewCols, WorldView *view);
+
+#endif
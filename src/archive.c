@@ -0,0 +1,154 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // mmap() under -std=c99
+#endif
+#include "archive.h"
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static bool map_file(Archive *archive, const char *path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    const void *data = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping) data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    archive->file = file;
+    archive->mapping = mapping;
+    archive->size = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file
+    if (data == MAP_FAILED) return false;
+    archive->size = (size_t)st.st_size;
+#endif
+    archive->data = data;
+    return true;
+}
+
+bool archive_open(Archive *archive, const char *path) {
+    memset(archive, 0, sizeof(Archive));
+    if (!map_file(archive, path)) return false;
+
+    const ArchiveHeader *header = (const ArchiveHeader *)archive->data;
+    bool ok = archive->size >= sizeof(ArchiveHeader) && header->magic == ARCHIVE_MAGIC &&
+              header->version == ARCHIVE_VERSION && header->bytes == archive->size &&
+              header->count <= (archive->size - sizeof(ArchiveHeader)) / sizeof(ArchiveEntry);
+
+    const ArchiveEntry *entries = (const ArchiveEntry *)(header + 1);
+    for (uint32_t i = 0; ok && i < header->count; i++) {
+        const ArchiveEntry *entry = &entries[i];
+        ok = memchr(entry->name, '\0', ARCHIVE_NAME_MAX) != NULL && entry->offset % ARCHIVE_ALIGN == 0 &&
+             entry->offset <= archive->size && entry->size <= archive->size - entry->offset &&
+             (entry->kind != ARCHIVE_IMAGE || (uint64_t)entry->width * entry->height * 4 == entry->size);
+    }
+    if (!ok) {
+        archive_close(archive);
+        return false;
+    }
+    archive->entries = entries;
+    archive->count = header->count;
+    return true;
+}
+
+void archive_close(Archive *archive) {
+    if (!archive->data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(archive->data);
+    CloseHandle(archive->mapping);
+    CloseHandle(archive->file);
+#else
+    munmap((void *)archive->data, archive->size);
+#endif
+    memset(archive, 0, sizeof(Archive));
+}
+
+const ArchiveEntry *archive_find(const Archive *archive, const char *name) {
+    for (uint32_t i = 0; i < archive->count; i++) {
+        if (strcmp(archive->entries[i].name, name) == 0) return &archive->entries[i];
+    }
+    return NULL;
+}
+
+static const ArchiveEntry *find_kind(const Archive *archive, const char *name, ArchiveKind kind) {
+    const ArchiveEntry *entry = archive->data ? archive_find(archive, name) : NULL;
+    return entry && entry->kind == (uint32_t)kind ? entry : NULL;
+}
+
+SDL_Texture *archive_texture(const Archive *archive, SDL_Renderer *renderer, const char *name) {
+    const ArchiveEntry *entry = find_kind(archive, name, ARCHIVE_IMAGE);
+    if (!entry) return NULL;
+
+    SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                             (int)entry->width, (int)entry->height);
+    if (!texture) return NULL;
+    if (SDL_UpdateTexture(texture, NULL, archive->data + entry->offset, (int)entry->width * 4) != 0) {
+        SDL_DestroyTexture(texture);
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND); // as IMG_LoadTexture() does for images with alpha
+    return texture;
+}
+
+SDL_Surface *archive_surface(const Archive *archive, const char *name) {
+    const ArchiveEntry *entry = find_kind(archive, name, ARCHIVE_IMAGE);
+    if (!entry) return NULL;
+    return SDL_CreateRGBSurfaceWithFormatFrom((void *)(archive->data + entry->offset), (int)entry->width, (int)entry->height,
+                                              32, (int)entry->width * 4, SDL_PIXELFORMAT_RGBA32);
+}
+
+Mix_Chunk *archive_chunk(const Archive *archive, const char *name) {
+    const ArchiveEntry *file = find_kind(archive, name, ARCHIVE_BLOB);
+    if (file) {
+        // Kept as the file by the packer: decoded now, as Mix_LoadWAV() would
+        SDL_RWops *rw = SDL_RWFromConstMem(archive->data + file->offset, (int)file->size);
+        return rw ? Mix_LoadWAV_RW(rw, 1) : NULL;
+    }
+
+    const ArchiveEntry *entry = find_kind(archive, name, ARCHIVE_SOUND);
+    if (!entry) return NULL;
+
+    int freq, channels;
+    Uint16 format;
+    if (!Mix_QuerySpec(&freq, &format, &channels) || freq != ARCHIVE_AUDIO_FREQ ||
+        format != ARCHIVE_AUDIO_FORMAT || channels != ARCHIVE_AUDIO_CHANNELS) return NULL;
+
+    // The chunk plays from the mapping and Mix_FreeChunk() leaves it alone; the mixer only reads it
+    return Mix_QuickLoad_RAW((Uint8 *)(archive->data + entry->offset), entry->size);
+}
+
+TTF_Font *archive_font(const Archive *archive, const char *name, int ptsize) {
+    const ArchiveEntry *entry = find_kind(archive, name, ARCHIVE_BLOB);
+    if (!entry) return NULL;
+
+    SDL_RWops *rw = SDL_RWFromConstMem(archive->data + entry->offset, (int)entry->size);
+    return rw ? TTF_OpenFontRW(rw, 1, ptsize) : NULL;
+}
+
+Mix_Music *archive_music(const Archive *archive, const char *name) {
+    const ArchiveEntry *entry = find_kind(archive, name, ARCHIVE_BLOB);
+    if (!entry) return NULL;
+
+    SDL_RWops *rw = SDL_RWFromConstMem(archive->data + entry->offset, (int)entry->size);
+    return rw ? Mix_LoadMUS_RW(rw, 1) : NULL;
+}
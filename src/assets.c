@@ -0,0 +1,122 @@
+#include "assets.h"
+#if defined(_WIN32) || defined(__APPLE__)
+#include <SDL_image.h>
+#else
+#include <SDL2/SDL_image.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+
+void asset_cache_init(AssetCache *cache, SDL_Renderer *renderer, const Archive *archive, const char *dir, size_t budget) {
+    memset(cache, 0, sizeof(AssetCache));
+    cache->renderer = renderer;
+    cache->archive = archive;
+    cache->budget = budget;
+    snprintf(cache->dir, sizeof(cache->dir), "%s", dir);
+}
+
+AssetId asset_cache_add(AssetCache *cache, const char *name, AssetKind kind) {
+    if (cache->count == ASSET_CACHE_MAX) return ASSET_NONE;
+    Asset *asset = &cache->assets[cache->count];
+    asset->name = name;
+    asset->kind = kind;
+    return cache->count++;
+}
+
+static void unload(AssetCache *cache, Asset *asset) {
+    if (asset->texture) SDL_DestroyTexture(asset->texture);
+    if (asset->music) Mix_FreeMusic(asset->music);
+    asset->texture = NULL;
+    asset->music = NULL;
+    cache->resident -= asset->bytes;
+    asset->bytes = 0;
+}
+
+// Music that is still playing is in use too: a screen may hand its sound over to the next one
+static bool evictable(const Asset *asset) {
+    if (asset->refs > 0 || (!asset->texture && !asset->music)) return false;
+    return !(asset->music && Mix_PlayingMusic());
+}
+
+// Least recently used first, until need more bytes fit or nothing else can go
+static void make_room(AssetCache *cache, size_t need) {
+    while (cache->resident + need > cache->budget) {
+        Asset *oldest = NULL;
+        for (uint8_t i = 0; i < cache->count; i++) {
+            Asset *asset = &cache->assets[i];
+            if (asset->bytes > 0 && evictable(asset) && (!oldest || asset->lastUse < oldest->lastUse)) oldest = asset;
+        }
+        if (!oldest) return;
+        unload(cache, oldest);
+        cache->evictions++;
+    }
+}
+
+static bool load(AssetCache *cache, Asset *asset) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s%s", cache->dir, asset->name);
+
+    if (asset->kind == ASSET_MUSIC) {
+        asset->music = archive_music(cache->archive, asset->name);
+        if (!asset->music) asset->music = Mix_LoadMUS(path);
+        return asset->music != NULL;
+    }
+
+    // Room first: the old texture goes before the new one is uploaded
+    const ArchiveEntry *entry = cache->archive->data ? archive_find(cache->archive, asset->name) : NULL;
+    if (entry && entry->kind == ARCHIVE_IMAGE) make_room(cache, entry->size);
+    asset->texture = archive_texture(cache->archive, cache->renderer, asset->name);
+    if (!asset->texture) asset->texture = IMG_LoadTexture(cache->renderer, path);
+    if (!asset->texture) return false;
+
+    int w = 0, h = 0;
+    SDL_QueryTexture(asset->texture, NULL, NULL, &w, &h);
+    asset->bytes = (size_t)w * h * 4;
+    cache->resident += asset->bytes;
+    if (cache->resident > cache->peak) cache->peak = cache->resident;
+    return true;
+}
+
+bool asset_cache_acquire(AssetCache *cache, AssetId id) {
+    if (id >= cache->count) return false;
+    Asset *asset = &cache->assets[id];
+    if (!asset->texture && !asset->music) {
+        if (!load(cache, asset)) return false;
+        asset->loads++;
+    }
+    asset->refs++;
+    asset->lastUse = ++cache->clock;
+    make_room(cache, 0); // a loose file is only measured once it is loaded
+    return true;
+}
+
+void asset_cache_release(AssetCache *cache, AssetId id) {
+    if (id >= cache->count || cache->assets[id].refs == 0) return;
+    Asset *asset = &cache->assets[id];
+    asset->refs--;
+    make_room(cache, 0);
+}
+
+SDL_Texture *asset_cache_texture(const AssetCache *cache, AssetId id) {
+    return id < cache->count ? cache->assets[id].texture : NULL;
+}
+
+Mix_Music *asset_cache_music(const AssetCache *cache, AssetId id) {
+    return id < cache->count ? cache->assets[id].music : NULL;
+}
+
+void asset_cache_report(const AssetCache *cache) {
+    printf("assets: %-8s %6s %6s %5s  %s\n", "state", "KB", "loads", "refs", "asset");
+    for (uint8_t i = 0; i < cache->count; i++) {
+        const Asset *asset = &cache->assets[i];
+        const char *state = asset->music ? "streamed" : asset->texture ? "resident" : asset->loads ? "evicted" : "unused";
+        printf("assets: %-8s %6zu %6u %5u  %s\n", state, asset->bytes >> 10, asset->loads, asset->refs, asset->name);
+    }
+    printf("assets: %zu KB resident, %zu KB peak, %zu KB budget, %u evictions\n",
+           cache->resident >> 10, cache->peak >> 10, cache->budget >> 10, cache->evictions);
+    fflush(stdout);
+}
+
+void asset_cache_free(AssetCache *cache) {
+    for (uint8_t i = 0; i < cache->count; i++) unload(cache, &cache->assets[i]);
+}
@@ -0,0 +1,393 @@
+#include "batch.h"
+#include "rules.h"
+#include "carve.h"
+#include "once.h"
+#include <string.h>
+
+static int16_t dotIndex[MAZE_TILES]; // compact dot number, -1 when the tile never holds a dot
+static uint64_t fullDotMask[BATCH_DOT_WORDS];
+static CoreOnce dotTablesOnce;
+
+// Packs the maze dot bitboard into BATCH_DOT_WORDS, so a game only stores its own dots.
+static bool build_dot_tables(const Maze *maze) {
+    if (maze->dotCount > BATCH_DOT_WORDS * 64) return false;
+    if (!core_once_begin(&dotTablesOnce)) return true;
+
+    int16_t count = 0;
+    memset(fullDotMask, 0, sizeof(fullDotMask));
+    for (uint16_t tile = 0; tile < MAZE_TILES; tile++) {
+        if (bitboard_test(maze->dots, tile)) {
+            dotIndex[tile] = count;
+            bitboard_set(fullDotMask, count);
+            count++;
+        } else {
+            dotIndex[tile] = -1;
+        }
+    }
+    core_once_end(&dotTablesOnce, true);
+    return true;
+}
+
+static size_t carve_all(BatchSim *sim, uint8_t *base) {
+    uint8_t *cur = base;
+    uint32_t n = sim->count, g = n * 4;
+
+    sim->pacRow      = carve(&cur, n);
+    sim->pacCol      = carve(&cur, n);
+    sim->pacDir      = carve(&cur, n);
+    sim->pacTimer    = carve(&cur, n * sizeof(uint16_t));
+    sim->ghostRow    = carve(&cur, g);
+    sim->ghostCol    = carve(&cur, g);
+    sim->ghostDir    = carve(&cur, g);
+    sim->ghostTimer  = carve(&cur, g * sizeof(uint16_t));
+    sim->ghostScared = carve(&cur, g);
+    sim->hunterTime  = carve(&cur, n * sizeof(int16_t));
+    sim->score       = carve(&cur, n * sizeof(uint16_t));
+    sim->lives       = carve(&cur, n);
+    sim->dotsEaten   = carve(&cur, n);
+    sim->rewardCount = carve(&cur, n);
+    sim->ghostCombo  = carve(&cur, n);
+    sim->state       = carve(&cur, n);
+    sim->rng         = carve(&cur, n * sizeof(uint32_t));
+    sim->events      = carve(&cur, n * sizeof(uint32_t));
+    sim->dotMask     = carve(&cur, n * BATCH_DOT_WORDS * sizeof(uint64_t));
+    sim->due         = carve(&cur, n);
+    sim->moved       = carve(&cur, n);
+    return (size_t)(cur - base);
+}
+
+static void reset_positions(BatchSim *sim, uint32_t i) {
+    const Maze *maze = sim->maze;
+    uint32_t n = sim->count;
+
+    sim->pacRow[i] = maze->pacmanStart[0];
+    sim->pacCol[i] = maze->pacmanStart[1];
+    sim->pacDir[i] = DIR_UP;
+    sim->hunterTime[i] = 0;
+    sim->ghostCombo[i] = 1;
+
+    for (int g = 0; g < 4; g++) {
+        sim->ghostRow[g * n + i] = maze->ghostStart[g][0];
+        sim->ghostCol[g * n + i] = maze->ghostStart[g][1];
+        sim->ghostScared[g * n + i] = false;
+        sim->ghostDir[g * n + i] = DIR_UP;
+    }
+}
+
+static void init_level(BatchSim *sim, uint32_t i, bool levelWon) {
+    if (levelWon) {
+        sim->dotsEaten[i] = 0;
+        if (sim->lives[i] < 3) sim->lives[i]++;
+        sim->rewardCount[i]++;
+    } else {
+        sim->score[i] = 0;
+        sim->lives[i] = 3;
+        sim->rewardCount[i] = 1;
+        sim->dotsEaten[i] = 0;
+    }
+
+    reset_positions(sim, i);
+    memcpy(&sim->dotMask[i * BATCH_DOT_WORDS], fullDotMask, sizeof(fullDotMask));
+    sim->state[i] = STATE_START_LEVEL;
+}
+
+void batch_init_game(BatchSim *sim, uint32_t i, uint32_t seed) {
+    uint32_t n = sim->count;
+
+    sim->pacTimer[i] = 0;
+    for (int g = 0; g < 4; g++) sim->ghostTimer[g * n + i] = 0;
+    sim->events[i] = CORE_EVENT_NONE;
+    sim->rng[i] = seed ? seed : 0x9E3779B9u; // same fallback as core_init()
+    init_level(sim, i, false);
+    if (sim->autoResume) sim->state[i] = STATE_PLAYING;
+}
+
+bool batch_init(BatchSim *sim, uint32_t count, uint32_t seed, bool autoResume) {
+    memset(sim, 0, sizeof(BatchSim));
+    sim->maze = maze_default();
+    if (count == 0 || !build_dot_tables(sim->maze)) return false;
+
+    sim->count = count;
+    sim->autoResume = autoResume;
+    size_t bytes = carve_all(sim, NULL);
+    sim->block = calloc(1, bytes + CARVE_SLACK);
+    if (!sim->block) {
+        sim->count = 0;
+        return false;
+    }
+    carve_all(sim, carve_base(sim->block));
+
+    for (uint32_t i = 0; i < count; i++) batch_init_game(sim, i, seed + i);
+    return true;
+}
+
+void batch_free(BatchSim *sim) {
+    free(sim->block);
+    memset(sim, 0, sizeof(BatchSim));
+}
+
+static inline bool is_playing(const BatchSim *sim, uint32_t i) {
+    return sim->state[i] == STATE_PLAYING;
+}
+
+static bool check_collisions(BatchSim *sim, uint32_t i) {
+    uint32_t n = sim->count;
+    for (uint32_t g = i; g < 4 * n; g += n) {
+        if (sim->pacRow[i] != sim->ghostRow[g] || sim->pacCol[i] != sim->ghostCol[g]) continue;
+
+        if (sim->hunterTime[i] > 0 && sim->ghostScared[g]) {
+            // Pacman eats ghost
+            sim->score[i] += sim->ghostCombo[i] * HUNTER_SCORE_MULTIPLIER;
+            sim->ghostCombo[i]++;
+            sim->ghostRow[g] = sim->maze->ghostHome[0];
+            sim->ghostCol[g] = sim->maze->ghostHome[1];
+            sim->ghostScared[g] = false;
+            sim->events[i] |= CORE_EVENT_EAT_GHOST | CORE_EVENT_SCORE;
+        } else {
+            if (--sim->lives[i] == 0) {
+                sim->state[i] = STATE_GAME_OVER;
+                sim->events[i] |= CORE_EVENT_GAME_OVER;
+            } else {
+                sim->state[i] = STATE_LIFE_LOST;
+                sim->events[i] |= CORE_EVENT_LIFE_LOST;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+static void step_hunters(BatchSim *sim) {
+    uint32_t n = sim->count;
+    for (uint32_t i = 0; i < n; i++) {
+        if (!is_playing(sim, i) || sim->hunterTime[i] <= 0) continue;
+
+        sim->hunterTime[i] -= DELTA_TICK;
+        if (sim->hunterTime[i] <= 0) {
+            sim->hunterTime[i] = 0;
+            for (int g = 0; g < 4; g++) sim->ghostScared[g * n + i] = false;
+            sim->events[i] |= CORE_EVENT_HUNTER_END;
+        }
+    }
+}
+
+static void move_ghost(BatchSim *sim, int g, uint32_t i) {
+    uint32_t k = g * sim->count + i;
+
+    Direction next;
+    if (!sim->ghostScared[k] || sim->hunterTime[i] == 0) {
+        if (!rules_forced_dir(sim->maze, sim->ghostRow[k], sim->ghostCol[k], sim->ghostDir[k], &next)) {
+            int8_t targetRow, targetCol;
+            rules_ghost_target(TYPE_BLINKY + g, sim->ghostRow[k], sim->ghostCol[k],
+                               sim->pacRow[i], sim->pacCol[i], sim->pacDir[i],
+                               sim->ghostRow[i], sim->ghostCol[i],
+                               &targetRow, &targetCol);
+            next = rules_chase_dir(sim->maze, sim->ghostRow[k], sim->ghostCol[k], sim->ghostDir[k], targetRow, targetCol);
+        }
+    } else {
+        next = rules_random_dir(sim->maze, sim->ghostRow[k], sim->ghostCol[k], sim->ghostDir[k], &sim->rng[i]);
+    }
+
+    int8_t r, c;
+    if (rules_next_tile(sim->maze, sim->ghostRow[k], sim->ghostCol[k], next, &r, &c)) {
+        sim->ghostRow[k] = r;
+        sim->ghostCol[k] = c;
+        sim->ghostDir[k] = next;
+        sim->moved[i] = true;
+    }
+}
+
+/* Bump every timer of one slot and flag the ones that fire this tick.
+ * Branch-free over plain arrays so the compiler can vectorize them. GCC's
+ * -O2 cost model only vectorizes a loop with no scalar remainder, so the
+ * games go through in blocks of BATCH_LANES, a constant trip count, and
+ * the last partial block on its own. */
+#define BATCH_LANES 16
+
+static inline void bump_ghost_span(uint16_t *restrict timer, uint8_t *restrict due, const uint8_t *restrict state,
+                                   const uint8_t *restrict scared, const uint8_t *restrict dotsEaten,
+                                   uint16_t baseTicks, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t playing = state[i] == STATE_PLAYING;
+        uint16_t eaten = dotsEaten[i];
+        uint16_t chase = baseTicks - (uint16_t)CORE_MS(eaten >> 3);
+        uint16_t required = scared[i] ? GHOST_FRIGHTENED_TICKS : chase;
+        uint16_t t = timer[i] + playing * DELTA_TICK;
+        timer[i] = t;
+        due[i] = playing & (t >= required);
+    }
+}
+
+static void bump_ghost_timers(uint16_t *timer, uint8_t *due, const uint8_t *state, const uint8_t *scared,
+                              const uint8_t *dotsEaten, uint16_t baseTicks, uint32_t n) {
+    uint32_t i = 0;
+    for (; i + BATCH_LANES <= n; i += BATCH_LANES) {
+        bump_ghost_span(&timer[i], &due[i], &state[i], &scared[i], &dotsEaten[i], baseTicks, BATCH_LANES);
+    }
+    bump_ghost_span(&timer[i], &due[i], &state[i], &scared[i], &dotsEaten[i], baseTicks, n - i);
+}
+
+static inline void bump_pacman_span(uint16_t *restrict timer, uint8_t *restrict due, const uint8_t *restrict state,
+                                    uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t playing = state[i] == STATE_PLAYING;
+        uint16_t t = timer[i] + playing * DELTA_TICK;
+        timer[i] = t;
+        due[i] = playing & (t >= BASE_TICKS);
+    }
+}
+
+static void bump_pacman_timers(uint16_t *timer, uint8_t *due, const uint8_t *state, uint32_t n) {
+    uint32_t i = 0;
+    for (; i + BATCH_LANES <= n; i += BATCH_LANES) bump_pacman_span(&timer[i], &due[i], &state[i], BATCH_LANES);
+    bump_pacman_span(&timer[i], &due[i], &state[i], n - i);
+}
+
+// Runs body for every flagged game, skipping eight clear flags per load.
+#define FOR_EACH_DUE(due, n, i, body)                                  \
+    for (uint32_t base_ = 0; base_ < (n); base_ += 8) {                \
+        uint64_t word_ = 0;                                             \
+        uint32_t len_ = (n) - base_ < 8 ? (n) - base_ : 8;              \
+        memcpy(&word_, &(due)[base_], len_);                            \
+        while (word_) {                                                 \
+            uint32_t i = base_ + (rules_lowest_bit(word_) >> 3);        \
+            word_ &= ~(0xFFull << ((i - base_) << 3));                  \
+            body                                                        \
+        }                                                               \
+    }
+
+// One ghost slot across every game; slots run in order because Inky reads Blinky.
+static void step_ghost(BatchSim *sim, int g) {
+    uint32_t n = sim->count;
+    uint16_t *timer = &sim->ghostTimer[g * n];
+
+    bump_ghost_timers(timer, sim->due, sim->state, &sim->ghostScared[g * n], sim->dotsEaten, ghostBaseTicks[g], n);
+    FOR_EACH_DUE(sim->due, n, i, {
+        timer[i] = 0;
+        move_ghost(sim, g, i);
+    })
+}
+
+static void eat_tile(BatchSim *sim, uint32_t i) {
+    uint16_t tile = maze_tile(sim->pacRow[i], sim->pacCol[i]);
+    int16_t dot = dotIndex[tile];
+    if (dot < 0) return;
+
+    uint64_t *mask = &sim->dotMask[i * BATCH_DOT_WORDS];
+    if (!bitboard_test(mask, dot)) return;
+
+    uint32_t n = sim->count;
+    bitboard_clear(mask, dot);
+    sim->dotsEaten[i]++;
+    if (bitboard_test(sim->maze->orbs, tile)) {
+        sim->hunterTime[i] = HUNTER_MODE_DURATION;
+        sim->score[i] += 50;
+        sim->ghostCombo[i] = 1;
+        for (int g = 0; g < 4; g++) sim->ghostScared[g * n + i] = true;
+        sim->events[i] |= CORE_EVENT_EAT_ORB | CORE_EVENT_SCORE;
+    } else {
+        sim->score[i] += 10;
+        sim->events[i] |= CORE_EVENT_EAT_DOT | CORE_EVENT_SCORE;
+    }
+
+    // Level completion check
+    if (bitboard_empty(mask, BATCH_DOT_WORDS)) {
+        if (sim->rewardCount[i] == 9) {
+            sim->state[i] = STATE_GAME_COMPLETE;
+            sim->events[i] |= CORE_EVENT_GAME_COMPLETE;
+        } else {
+            init_level(sim, i, true);
+            sim->events[i] |= CORE_EVENT_LEVEL_COMPLETE;
+        }
+    }
+}
+
+static void move_pacman(BatchSim *sim, uint32_t i) {
+    int8_t r, c;
+    if (!rules_next_tile(sim->maze, sim->pacRow[i], sim->pacCol[i], sim->pacDir[i], &r, &c)) return;
+    sim->pacRow[i] = r;
+    sim->pacCol[i] = c;
+    if (check_collisions(sim, i)) return;
+
+    eat_tile(sim, i);
+}
+
+static void step_pacmen(BatchSim *sim) {
+    uint32_t n = sim->count;
+
+    bump_pacman_timers(sim->pacTimer, sim->due, sim->state, n);
+    FOR_EACH_DUE(sim->due, n, i, {
+        sim->pacTimer[i] = 0;
+        move_pacman(sim, i);
+    })
+}
+
+void batch_step(BatchSim *sim, const uint8_t *inputs) {
+    uint32_t n = sim->count;
+
+    for (uint32_t i = 0; i < n; i++) {
+        sim->events[i] = CORE_EVENT_NONE;
+        if (inputs && inputs[i] < DIR_COUNT && is_playing(sim, i)) sim->pacDir[i] = inputs[i];
+    }
+
+    step_hunters(sim);
+    memset(sim->moved, 0, n);
+    for (int g = 0; g < 4; g++) step_ghost(sim, g);
+
+    // Positions only change when a ghost moved, so only those games can collide.
+    FOR_EACH_DUE(sim->moved, n, i, {
+        if (is_playing(sim, i)) check_collisions(sim, i);
+    })
+    step_pacmen(sim);
+
+    if (!sim->autoResume) return;
+    for (uint32_t i = 0; i < n; i++) {
+        if (sim->state[i] == STATE_LIFE_LOST) {
+            reset_positions(sim, i);
+            sim->state[i] = STATE_PLAYING;
+        } else if (sim->state[i] == STATE_START_LEVEL) {
+            sim->state[i] = STATE_PLAYING;
+        }
+    }
+}
+
+void batch_get_game(const BatchSim *sim, uint32_t i, GameLogic *out) {
+    uint32_t n = sim->count;
+    memset(out, 0, sizeof(GameLogic));
+
+    const uint64_t *mask = &sim->dotMask[i * BATCH_DOT_WORDS];
+    memcpy(out->map, sim->maze->map, sizeof(out->map));
+    for (uint16_t tile = 0; tile < MAZE_TILES; tile++) {
+        int16_t dot = dotIndex[tile];
+        if (dot < 0) continue;
+        if (bitboard_test(mask, dot)) bitboard_set(out->dots, tile);
+        else out->map[sim->maze->tileRow[tile]][sim->maze->tileCol[tile]] = ' ';
+    }
+
+    out->maze = sim->maze;
+    out->player.pacman.kind = TYPE_PACMAN;
+    out->player.pacman.row = sim->pacRow[i];
+    out->player.pacman.col = sim->pacCol[i];
+    out->player.pacman.dir = sim->pacDir[i];
+    out->player.pacman.moveTimer = sim->pacTimer[i];
+    out->player.score = sim->score[i];
+    out->player.hunterTime = sim->hunterTime[i];
+    out->player.lives = sim->lives[i];
+    out->player.dotsEaten = sim->dotsEaten[i];
+    out->player.rewardCount = sim->rewardCount[i];
+    out->player.ghostCombo = sim->ghostCombo[i];
+
+    for (int g = 0; g < 4; g++) {
+        out->ghosts[g].kind = TYPE_BLINKY + g;
+        out->ghosts[g].row = sim->ghostRow[g * n + i];
+        out->ghosts[g].col = sim->ghostCol[g * n + i];
+        out->ghosts[g].dir = sim->ghostDir[g * n + i];
+        out->ghosts[g].moveTimer = sim->ghostTimer[g * n + i];
+        out->ghosts[g].scared = sim->ghostScared[g * n + i];
+    }
+
+    out->state = sim->state[i];
+    out->prevState = sim->state[i];
+    out->events = sim->events[i];
+    out->rng = sim->rng[i];
+}
@@ -0,0 +1,27 @@
+#ifndef PACMAN_CORE_CARVE_H
+#define PACMAN_CORE_CARVE_H
+
+/* Structure-of-arrays storage in one allocation, for the batched engine and
+ * the swarm. Each keeps a carve_all() that hands out its arrays in order:
+ * run once from NULL to size the block, allocate bytes + CARVE_SLACK, then
+ * run again from carve_base() of the block. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CARVE_ALIGN 64 // a cache line, so no two arrays share one
+#define CARVE_SLACK (CARVE_ALIGN - 1)
+
+// Carves the next CARVE_ALIGN aligned array out of the shared block.
+static inline void *carve(uint8_t **cursor, size_t bytes) {
+    void *p = *cursor;
+    *cursor += (bytes + CARVE_SLACK) & ~(size_t)CARVE_SLACK;
+    return p;
+}
+
+// First aligned byte of a block allocated with CARVE_SLACK to spare.
+static inline uint8_t *carve_base(void *block) {
+    return (uint8_t *)(((uintptr_t)block + CARVE_SLACK) & ~(uintptr_t)CARVE_SLACK);
+}
+
+#endif
@@ -0,0 +1,111 @@
+#include "chase4.h"
+#include "rules.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Lane g*4+d holds ghost g moving in direction d. Targets stay within a few
+ * tiles of the board (Inky's doubled vector is the widest), so distances are
+ * below 8000 and distance << 2 | dir fits in 16 bits. Lanes that are walls
+ * or the reverse direction score 0xFFFF. */
+#define CHASE4_BLOCKED 0xFFFF
+
+static const int16_t laneRowOffset[16] = {-1, 0, 1, 0, -1, 0, 1, 0, -1, 0, 1, 0, -1, 0, 1, 0};
+static const int16_t laneColOffset[16] = {0, -1, 0, 1, 0, -1, 0, 1, 0, -1, 0, 1, 0, -1, 0, 1};
+static const int16_t laneBit[16] = {1, 2, 4, 8, 1, 2, 4, 8, 1, 2, 4, 8, 1, 2, 4, 8};
+static const int16_t laneDir[16] = {0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3};
+
+typedef struct {
+  int16_t row[16], col[16], targetRow[16], targetCol[16], candidates[16];
+} Lanes;
+
+static void spread_lanes(const Maze *maze, const int8_t row[4], const int8_t col[4], const Direction dir[4],
+                         const int8_t targetRow[4], const int8_t targetCol[4], Lanes *lanes) {
+    for (int g = 0; g < 4; g++) {
+        uint8_t candidates = maze->chaseMask[maze_tile(row[g], col[g])] & ~(1 << rules_reverse(dir[g]));
+        for (int d = 0; d < 4; d++) {
+            lanes->row[g * 4 + d] = row[g];
+            lanes->col[g * 4 + d] = col[g];
+            lanes->targetRow[g * 4 + d] = targetRow[g];
+            lanes->targetCol[g * 4 + d] = targetCol[g];
+            lanes->candidates[g * 4 + d] = candidates;
+        }
+    }
+}
+
+static Direction pick(uint16_t best, Direction current) {
+    return best == CHASE4_BLOCKED ? rules_reverse(current) : (Direction)(best & 3);
+}
+
+void chase4_dirs_scalar(const Maze *maze, const int8_t row[4], const int8_t col[4], const Direction dir[4],
+                        const int8_t targetRow[4], const int8_t targetCol[4], Direction out[4]) {
+    Lanes lanes;
+    spread_lanes(maze, row, col, dir, targetRow, targetCol, &lanes);
+
+    for (int g = 0; g < 4; g++) {
+        uint16_t best = CHASE4_BLOCKED;
+        for (int d = 0; d < 4; d++) {
+            int lane = g * 4 + d;
+            if (!(lanes.candidates[lane] & laneBit[lane])) continue;
+
+            int dr = lanes.targetRow[lane] - (lanes.row[lane] + laneRowOffset[lane]);
+            int dc = lanes.targetCol[lane] - (lanes.col[lane] + laneColOffset[lane]);
+            uint16_t key = (uint16_t)((dr * dr + dc * dc) << 2 | laneDir[lane]);
+            if (key < best) best = key;
+        }
+        out[g] = pick(best, dir[g]);
+    }
+}
+
+#if defined(__SSE2__)
+
+// One register holds two ghosts; shufflelo/shufflehi reduce each half on its own.
+static __m128i reduce_pair(const Lanes *lanes, int first) {
+    __m128i bit = _mm_loadu_si128((const __m128i *)&laneBit[first]);
+    __m128i dr = _mm_sub_epi16(_mm_loadu_si128((const __m128i *)&lanes->targetRow[first]),
+                 _mm_add_epi16(_mm_loadu_si128((const __m128i *)&lanes->row[first]), _mm_loadu_si128((const __m128i *)&laneRowOffset[first])));
+    __m128i dc = _mm_sub_epi16(_mm_loadu_si128((const __m128i *)&lanes->targetCol[first]),
+                 _mm_add_epi16(_mm_loadu_si128((const __m128i *)&lanes->col[first]), _mm_loadu_si128((const __m128i *)&laneColOffset[first])));
+    __m128i dist = _mm_add_epi16(_mm_mullo_epi16(dr, dr), _mm_mullo_epi16(dc, dc));
+    __m128i key = _mm_or_si128(_mm_slli_epi16(dist, 2), _mm_loadu_si128((const __m128i *)&laneDir[first]));
+
+    // Blocked lanes become 0xFFFF; the bias turns the unsigned order into the signed one min_epi16 uses
+    __m128i open = _mm_cmpeq_epi16(_mm_and_si128(_mm_loadu_si128((const __m128i *)&lanes->candidates[first]), bit), bit);
+    key = _mm_or_si128(key, _mm_andnot_si128(open, _mm_set1_epi16(-1)));
+    key = _mm_xor_si128(key, _mm_set1_epi16((short)0x8000));
+
+    key = _mm_min_epi16(key, _mm_shufflehi_epi16(_mm_shufflelo_epi16(key, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1)));
+    key = _mm_min_epi16(key, _mm_shufflehi_epi16(_mm_shufflelo_epi16(key, _MM_SHUFFLE(1, 0, 3, 2)), _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_xor_si128(key, _mm_set1_epi16((short)0x8000));
+}
+
+void chase4_dirs(const Maze *maze, const int8_t row[4], const int8_t col[4], const Direction dir[4],
+                 const int8_t targetRow[4], const int8_t targetCol[4], Direction out[4]) {
+    Lanes lanes;
+    spread_lanes(maze, row, col, dir, targetRow, targetCol, &lanes);
+
+    __m128i low = reduce_pair(&lanes, 0);
+    __m128i high = reduce_pair(&lanes, 8);
+    out[0] = pick((uint16_t)_mm_extract_epi16(low, 0), dir[0]);
+    out[1] = pick((uint16_t)_mm_extract_epi16(low, 4), dir[1]);
+    out[2] = pick((uint16_t)_mm_extract_epi16(high, 0), dir[2]);
+    out[3] = pick((uint16_t)_mm_extract_epi16(high, 4), dir[3]);
+}
+
+const char *chase4_isa(void) {
+    return "sse2";
+}
+
+#else
+
+void chase4_dirs(const Maze *maze, const int8_t row[4], const int8_t col[4], const Direction dir[4],
+                 const int8_t targetRow[4], const int8_t targetCol[4], Direction out[4]) {
+    chase4_dirs_scalar(maze, row, col, dir, targetRow, targetCol, out);
+}
+
+const char *chase4_isa(void) {
+    return "scalar";
+}
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef PACMAN_CORE_CHASE4_H
+#define PACMAN_CORE_CHASE4_H
+
+/* rules_chase_dir() for the four ghosts at once: 4 ghosts x 4 directions of
+ * squared distances, wall masks and reverse exclusion in one pass. Each lane
+ * is scored as distance << 2 | dir, so one horizontal min per ghost also
+ * applies the directionOffsets tie-break. Built with SSE2 when the compiler
+ * targets it (every x86-64 build), plain C otherwise. */
+
+#include "core.h"
+
+void chase4_dirs(const Maze *maze, const int8_t row[4], const int8_t col[4], const Direction dir[4],
+                 const int8_t targetRow[4], const int8_t targetCol[4], Direction out[4]);
+
+// Same result without SIMD, whatever the build targets.
+void chase4_dirs_scalar(const Maze *maze, const int8_t row[4], const int8_t col[4], const Direction dir[4],
+                        const int8_t targetRow[4], const int8_t targetCol[4], Direction out[4]);
+
+const char *chase4_isa(void); // "sse2" or "scalar"
+
+#endif
@@ -0,0 +1,309 @@
+#include "core.h"
+#include "step.h"
+#include "rules.h"
+#include "chase4.h"
+#include <string.h>
+
+const char pacman_map[MAP_ROWS][MAP_COLS] = {
+"############################",
+"#............##............#",
+"#.####.#####.##.#####.####.#",
+"#o#  #.#   #.##.#   #.#  #o#",
+"#.####.#####.##.#####.####.#",
+"#..........................#",
+"#.####.##.########.##.####.#",
+"#.####.##.########.##.####.#",
+"#......##....##....##......#",
+"######.##### ## #####.######",
+"######.##### ## #####.######",
+"######.##          ##.######",
+"######.## ###  ### ##.######",
+"######.## ##    ## ##.######",
+"      .   ########   .      ",
+"######.## ######## ##.######",
+"######.## ######## ##.######",
+"######.##          ##.######",
+"######.## ######## ##.######",
+"######.## ######## ##.######",
+"#............##............#",
+"#.####.#####.##.#####.####.#",
+"#.####.#####.##.#####.####.#",
+"#o..##.......  .......##..o#",
+"###.##.##.########.##.##.###",
+"###.##.##.########.##.##.###",
+"#......##....##....##......#",
+"#.##########.##.##########.#",
+"#.##########.##.##########.#",
+"#..........................#",
+"############################"
+};
+
+const int8_t directionOffsets[4][2] = {
+  {-1, 0}, {0, -1}, {1, 0}, {0, 1}
+};
+
+const uint16_t ghostBaseTicks[4] = {
+    BASE_TICKS*125/100,
+    BASE_TICKS*135/100,
+    BASE_TICKS*145/100,
+    BASE_TICKS*155/100
+};
+
+void core_reset_positions(GameLogic *game) {
+    // Reset pacman
+    game->player.pacman.row = game->maze->pacmanStart[0];
+    game->player.pacman.col = game->maze->pacmanStart[1];
+    game->player.pacman.dir = DIR_UP;
+    game->player.hunterTime = 0;
+    game->player.ghostCombo = 1;
+
+    // Reset ghosts
+    for (int i = 0; i < 4; i++) {
+        game->ghosts[i].row = game->maze->ghostStart[i][0];
+        game->ghosts[i].col = game->maze->ghostStart[i][1];
+        game->ghosts[i].scared = false;
+        game->ghosts[i].dir = DIR_UP;
+        game->ghosts[i].kind = TYPE_BLINKY+i;
+    }
+}
+
+void core_init_level(GameLogic *game, bool levelWon) {
+    if (levelWon) {
+        game->player.dotsEaten = 0;
+        if (game->player.lives < 3) game->player.lives++;
+        game->player.rewardCount++;
+    } else {
+        game->player.score = 0;
+        game->player.lives = 3;
+        game->player.rewardCount = 1;
+        game->player.dotsEaten = 0;
+    }
+
+    core_reset_positions(game);
+    memcpy(game->dots, game->maze->dots, sizeof(game->dots));
+    memcpy(game->map, game->maze->map, sizeof(game->map));
+    game->state = STATE_START_LEVEL;
+}
+
+void core_init(GameLogic *game, uint32_t seed) {
+    memset(game, 0, sizeof(GameLogic));
+    game->maze = maze_default();
+    game->rng = seed ? seed : 0x9E3779B9u; // xorshift must not start at 0
+    core_init_level(game, false);
+}
+
+void core_resume(GameLogic *game) {
+    if (game->state == STATE_LIFE_LOST) {
+        core_reset_positions(game);
+        game->state = STATE_START_LEVEL;
+    } else if (game->state == STATE_START_LEVEL) {
+        game->state = STATE_PLAYING;
+    }
+}
+
+bool core_check_collisions(GameLogic *game) {
+    uint8_t i = 0;
+    for (; i < 4; i++) {
+        if (game->player.pacman.row == game->ghosts[i].row &&
+            game->player.pacman.col == game->ghosts[i].col) {
+
+            if (game->player.hunterTime > 0 && game->ghosts[i].scared) {
+                // Pacman eats ghost
+                game->player.score += game->player.ghostCombo * HUNTER_SCORE_MULTIPLIER;
+                game->player.ghostCombo++;
+                game->ghosts[i].row = game->maze->ghostHome[0];
+                game->ghosts[i].col = game->maze->ghostHome[1];
+                game->ghosts[i].scared = false;
+                game->events |= CORE_EVENT_EAT_GHOST | CORE_EVENT_SCORE;
+            }else{
+                if(--game->player.lives == 0){
+                    game->state = STATE_GAME_OVER;
+                    game->events |= CORE_EVENT_GAME_OVER;
+                }else{
+                    game->state =  STATE_LIFE_LOST;
+                    game->events |= CORE_EVENT_LIFE_LOST;
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool core_try_move(GameLogic *game, GameEntity *entity, Direction dir) {
+    int8_t nextRow, nextCol;
+    if (!rules_next_tile(game->maze, entity->row, entity->col, dir, &nextRow, &nextCol)) return false;
+
+    entity->row = nextRow;
+    entity->col = nextCol;
+    entity->dir = dir;
+    return true;
+}
+
+static Direction chase_dir(const GameLogic *game, const GameEntity *ghost) {
+    const GameEntity *pacman = &game->player.pacman;
+    int8_t targetRow, targetCol;
+    rules_ghost_target(ghost->kind, ghost->row, ghost->col,
+                       pacman->row, pacman->col, pacman->dir,
+                       game->ghosts[0].row, game->ghosts[0].col,
+                       &targetRow, &targetCol);
+    return game->paths ? rules_path_dir(game->maze, game->paths, ghost->row, ghost->col, ghost->dir, targetRow, targetCol)
+                       : rules_chase_dir(game->maze, ghost->row, ghost->col, ghost->dir, targetRow, targetCol);
+}
+
+// Classic chase choice for all four ghosts in one pass, from the positions at the start of the tick.
+static void chase_dirs(const GameLogic *game, Direction out[4]) {
+    const GameEntity *pacman = &game->player.pacman;
+    int8_t row[4], col[4], targetRow[4], targetCol[4];
+    Direction dir[4];
+
+    for (int i = 0; i < 4; i++) {
+        const GameEntity *ghost = &game->ghosts[i];
+        row[i] = ghost->row;
+        col[i] = ghost->col;
+        dir[i] = ghost->dir;
+        rules_ghost_target(ghost->kind, ghost->row, ghost->col,
+                           pacman->row, pacman->col, pacman->dir,
+                           game->ghosts[0].row, game->ghosts[0].col,
+                           &targetRow[i], &targetCol[i]);
+    }
+    chase4_dirs(game->maze, row, col, dir, targetRow, targetCol, out);
+}
+
+void core_update_ghosts(GameLogic *game) {
+    uint8_t due = 0, chasing = 0, branching = 0;
+    bool hunting = game->player.hunterTime != 0;
+    Direction chase[4];
+
+    // Calculate speed based on ghost type and game progress
+    for (int i = 0; i < 4; i++) {
+        GameEntity *ghost = &game->ghosts[i];
+        ghost->moveTimer += DELTA_TICK;
+        if (ghost->moveTimer < rules_ghost_ticks(i, ghost->scared, game->player.dotsEaten)) continue;
+        ghost->moveTimer = 0;
+        due |= 1 << i;
+        if (ghost->scared && hunting) continue;
+
+        // Targets only matter where the corridor branches
+        chasing |= 1 << i;
+        if (!rules_forced_dir(game->maze, ghost->row, ghost->col, ghost->dir, &chase[i])) branching |= 1 << i;
+    }
+
+    // Several real decisions this tick: score them all in one pass
+    bool batched = !game->paths && (branching & (branching - 1));
+    if (batched) chase_dirs(game, chase);
+
+    int8_t blinkyRow = game->ghosts[0].row, blinkyCol = game->ghosts[0].col;
+    for (int i = 0; i < 4; i++) {
+        if (!((due >> i) & 1)) continue;
+        GameEntity *ghost = &game->ghosts[i];
+
+        Direction dir;
+        if ((chasing >> i) & 1) {
+            // Inky aims off Blinky, who may have moved earlier in this loop
+            bool blinkyMoved = game->ghosts[0].row != blinkyRow || game->ghosts[0].col != blinkyCol;
+            bool stale = ghost->kind == TYPE_INKY && blinkyMoved;
+            dir = ((branching >> i) & 1) && (!batched || stale) ? chase_dir(game, ghost) : chase[i];
+        } else {
+            dir = rules_random_dir(game->maze, ghost->row, ghost->col, ghost->dir, &game->rng);
+        }
+        core_try_move(game, ghost, dir);
+    }
+}
+
+static void update_hunter(GameLogic *game) {
+    if (game->player.hunterTime <= 0) return;
+
+    game->player.hunterTime -= DELTA_TICK;
+    if (game->player.hunterTime <= 0) {
+        game->player.hunterTime = 0;
+        for (int i = 0; i < 4; i++) {
+            game->ghosts[i].scared = false;
+        }
+        game->events |= CORE_EVENT_HUNTER_END;
+    }
+}
+
+static void update_pacman(GameLogic *game) {
+    game->player.pacman.moveTimer += DELTA_TICK;
+    if (game->player.pacman.moveTimer < BASE_TICKS) return;
+
+    game->player.pacman.moveTimer = 0;
+    GameEntity *pacman = &game->player.pacman;
+    if (!core_try_move(game, pacman, pacman->dir)) {
+        return; // Pacman couldn't move in desired direction
+    }
+    if (core_check_collisions(game)) return;
+
+    uint16_t tile = maze_tile(pacman->row, pacman->col);
+    if (!bitboard_test(game->dots, tile)) return;
+
+    bitboard_clear(game->dots, tile);
+    game->map[pacman->row][pacman->col] = ' ';
+    game->player.dotsEaten++;
+    if (bitboard_test(game->maze->orbs, tile)) {
+        game->player.hunterTime = HUNTER_MODE_DURATION;
+        game->player.score += 50;
+        game->player.ghostCombo = 1;
+        for (int i = 0; i < 4; i++) {
+            game->ghosts[i].scared = true;
+        }
+        game->events |= CORE_EVENT_EAT_ORB | CORE_EVENT_SCORE;
+    }else {
+        game->player.score += 10;
+        game->events |= CORE_EVENT_EAT_DOT | CORE_EVENT_SCORE;
+    }
+
+    // Level completion check
+    if (bitboard_empty(game->dots, MAZE_WORDS)) {
+        if (game->player.rewardCount == 9) {
+            game->state = STATE_GAME_COMPLETE;
+            game->events |= CORE_EVENT_GAME_COMPLETE;
+        } else {
+            core_init_level(game,true);
+            game->events |= CORE_EVENT_LEVEL_COMPLETE;
+        }
+    }
+}
+
+uint32_t core_step(GameLogic *game, Direction input) {
+    game->events = CORE_EVENT_NONE;
+    if (game->state != STATE_PLAYING) return game->events;
+
+    if (input < DIR_COUNT) game->player.pacman.dir = input;
+
+    update_hunter(game);
+    core_update_ghosts(game);
+    if (!core_check_collisions(game)) update_pacman(game);
+    return game->events;
+}
+
+uint32_t core_events(const GameLogic *game) {
+    return game->events;
+}
+
+uint16_t core_move_period(const GameLogic *game, const GameEntity *entity) {
+    if (entity == &game->player.pacman) return BASE_TICKS;
+    int i = (int)(entity - game->ghosts);
+    return rules_ghost_ticks(i, entity->scared, game->player.dotsEaten);
+}
+
+static bool same_entity(const GameEntity *a, const GameEntity *b) {
+    return a->kind == b->kind && a->dir == b->dir && a->moveTimer == b->moveTimer &&
+           a->row == b->row && a->col == b->col && a->scared == b->scared;
+}
+
+bool core_same_state(const GameLogic *a, const GameLogic *b) {
+    if (a->maze != b->maze || a->paths != b->paths || memcmp(a->dots, b->dots, sizeof(a->dots)) != 0 ||
+        memcmp(a->map, b->map, sizeof(a->map)) != 0) return false;
+
+    const PlayerData *pa = &a->player, *pb = &b->player;
+    if (!same_entity(&pa->pacman, &pb->pacman) || pa->score != pb->score || pa->hunterTime != pb->hunterTime ||
+        pa->lives != pb->lives || pa->dotsEaten != pb->dotsEaten ||
+        pa->rewardCount != pb->rewardCount || pa->ghostCombo != pb->ghostCombo) return false;
+
+    for (int i = 0; i < 4; i++) {
+        if (!same_entity(&a->ghosts[i], &b->ghosts[i])) return false;
+    }
+    return a->state == b->state && a->prevState == b->prevState && a->events == b->events && a->rng == b->rng;
+}
@@ -0,0 +1,148 @@
+#include "level.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+static bool fail(char *error, size_t errorSize, int line, const char *fmt, ...) {
+    va_list args;
+    int used = line ? snprintf(error, errorSize, "line %d: ", line) : 0;
+
+    if (used < 0 || (size_t)used >= errorSize) return false;
+    va_start(args, fmt);
+    vsnprintf(error + used, errorSize - used, fmt, args);
+    va_end(args);
+    return false;
+}
+
+// The tunnel column is not a tile.
+static bool on_board(int row, int col) {
+    return row >= 0 && row < MAP_ROWS && col >= 0 && col < MAP_COLS-1;
+}
+
+bool level_compile(Level *level, const char *text, char *error, size_t errorSize) {
+    char map[MAP_ROWS][MAP_COLS];
+    int pacman[2] = {-1, -1}, ghosts[4][2], home[2] = {-1, -1};
+    int tunnel = -1, wallX = 224, wallY = 0;
+    int ghostCount = 0, mapRows = -1, lineNo = 0;
+
+    memset(map, ' ', sizeof(map));
+    while (*text) {
+        size_t len = strcspn(text, "\n");
+        const char *line = text;
+        text += len + (text[len] == '\n');
+        if (len && line[len-1] == '\r') len--;
+        lineNo++;
+
+        if (mapRows >= 0) {
+            if (mapRows == MAP_ROWS) {
+                if (strspn(line, " \t") < len) return fail(error, errorSize, lineNo, "more than %d map rows", MAP_ROWS);
+                continue;
+            }
+            if (len > MAP_COLS-1) return fail(error, errorSize, lineNo, "row wider than %d tiles", MAP_COLS-1);
+            for (size_t col = 0; col < len; col++) {
+                if (!strchr("#.o ", line[col])) return fail(error, errorSize, lineNo, "unknown tile '%c'", line[col]);
+                map[mapRows][col] = line[col];
+            }
+            map[mapRows++][MAP_COLS-1] = '\0';
+            continue;
+        }
+
+        char directive[16], rest[2];
+        int a, b, fields;
+        char buf[128];
+        if (len >= sizeof(buf)) return fail(error, errorSize, lineNo, "line too long");
+        memcpy(buf, line, len);
+        buf[len] = '\0';
+
+        fields = sscanf(buf, " %15s %d %d %1s", directive, &a, &b, rest);
+        if (fields <= 0 || directive[0] == '#') continue;
+
+        if (strcmp(directive, "map") == 0 && fields == 1) {
+            mapRows = 0;
+        } else if (strcmp(directive, "tunnel") == 0 && fields == 2) {
+            tunnel = a;
+        } else if (fields != 3) {
+            return fail(error, errorSize, lineNo, "bad directive \"%s\"", buf);
+        } else if (strcmp(directive, "pacman") == 0) {
+            pacman[0] = a; pacman[1] = b;
+        } else if (strcmp(directive, "ghost") == 0 && ghostCount < 4) {
+            ghosts[ghostCount][0] = a; ghosts[ghostCount++][1] = b;
+        } else if (strcmp(directive, "home") == 0) {
+            home[0] = a; home[1] = b;
+        } else if (strcmp(directive, "walls") == 0 && a >= 0 && b >= 0) {
+            wallX = a; wallY = b;
+        } else {
+            return fail(error, errorSize, lineNo, "bad directive \"%s\"", buf);
+        }
+    }
+
+    if (mapRows != MAP_ROWS) return fail(error, errorSize, 0, "map needs %d rows, found %d", MAP_ROWS, mapRows < 0 ? 0 : mapRows);
+    if (!on_board(pacman[0], pacman[1]) || map[pacman[0]][pacman[1]] == '#') return fail(error, errorSize, 0, "pacman start missing or in a wall");
+    if (ghostCount != 4) return fail(error, errorSize, 0, "need 4 ghost starts, found %d", ghostCount);
+    // Ghosts may start and respawn inside the house walls (the classic Clyde
+    // and home tiles are walls), so only the bounds are checked
+    for (int i = 0; i < 4; i++) {
+        if (!on_board(ghosts[i][0], ghosts[i][1])) return fail(error, errorSize, 0, "ghost %d starts off the board", i);
+    }
+    if (!on_board(home[0], home[1])) return fail(error, errorSize, 0, "ghost home missing or off the board");
+    if (tunnel < 0 || tunnel >= MAP_ROWS) return fail(error, errorSize, 0, "tunnel row missing or off the board");
+
+    memset(level, 0, sizeof(Level)); // padding too, so the same text always bakes the same bytes
+    level->header.magic = LEVEL_MAGIC;
+    level->header.version = LEVEL_VERSION;
+    level->header.bytes = sizeof(Level);
+    level->header.rows = MAP_ROWS;
+    level->header.cols = MAP_COLS;
+
+    maze_build(&level->maze, (const char (*)[MAP_COLS])map, (int8_t)tunnel);
+    level->maze.pacmanStart[0] = pacman[0];
+    level->maze.pacmanStart[1] = pacman[1];
+    for (int i = 0; i < 4; i++) {
+        level->maze.ghostStart[i][0] = ghosts[i][0];
+        level->maze.ghostStart[i][1] = ghosts[i][1];
+    }
+    level->maze.ghostHome[0] = home[0];
+    level->maze.ghostHome[1] = home[1];
+    if (level->maze.dotCount == 0) return fail(error, errorSize, 0, "no dots to eat");
+    if (level->maze.dotCount > MAX_LEVEL_DOTS) {
+        return fail(error, errorSize, 0, "%u dots, a board holds at most %d", level->maze.dotCount, MAX_LEVEL_DOTS);
+    }
+
+    // Wall art is one picture of the whole board, each tile draws its own cell of it
+    for (uint16_t tile = 0; tile < MAZE_TILES; tile++) {
+        level->wallSrc[tile][0] = wallX + level->maze.tileCol[tile] * LEVEL_ART_TILE;
+        level->wallSrc[tile][1] = wallY + level->maze.tileRow[tile] * LEVEL_ART_TILE;
+    }
+    return true;
+}
+
+bool level_save(const Level *level, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (!file) return false;
+
+    bool ok = fwrite(level, sizeof(Level), 1, file) == 1;
+    return fclose(file) == 0 && ok;
+}
+
+bool level_load(Level *level, const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+
+    bool ok = fread(level, sizeof(Level), 1, file) == 1;
+    fclose(file);
+    if (!ok) return false;
+
+    const LevelHeader *header = &level->header;
+    if (header->magic != LEVEL_MAGIC || header->version != LEVEL_VERSION || header->bytes != sizeof(Level) ||
+        header->rows != MAP_ROWS || header->cols != MAP_COLS) return false;
+
+    // The same bounds level_compile() enforces, the game indexes its tables with these
+    const Maze *maze = &level->maze;
+    if (!on_board(maze->pacmanStart[0], maze->pacmanStart[1])) return false;
+    for (int i = 0; i < 4; i++) {
+        if (!on_board(maze->ghostStart[i][0], maze->ghostStart[i][1])) return false;
+    }
+    if (!on_board(maze->ghostHome[0], maze->ghostHome[1])) return false;
+    return maze->tunnelRow >= 0 && maze->tunnelRow < MAP_ROWS &&
+           maze->dotCount > 0 && maze->dotCount <= MAX_LEVEL_DOTS;
+}
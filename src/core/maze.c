@@ -0,0 +1,83 @@
+#include "maze.h"
+#include "core.h"
+#include "once.h"
+#include <string.h>
+
+// Mirrors the old try_move(): leaving a side of the map warps into the tunnel row.
+static bool build_move(const char map[MAP_ROWS][MAP_COLS], int8_t tunnelRow, int row, int col, int dir, uint16_t *out) {
+    int nextRow = row + directionOffsets[dir][0];
+    int nextCol = col + directionOffsets[dir][1];
+
+    if (nextCol < 0) {
+        nextCol = MAP_COLS-1;
+        nextRow = tunnelRow;
+    } else if (nextCol >= MAP_COLS-1) {
+        nextCol = 0;
+        nextRow = tunnelRow;
+    }
+
+    if (nextRow < 0 || nextRow >= MAP_ROWS || map[nextRow][nextCol] == '#') return false;
+    *out = maze_tile(nextRow, nextCol);
+    return true;
+}
+
+// Mirrors the candidate filter in update_ghosts(): no warp, bounds and walls only.
+static bool build_chase(const char map[MAP_ROWS][MAP_COLS], int row, int col, int dir) {
+    int nextRow = row + directionOffsets[dir][0];
+    int nextCol = col + directionOffsets[dir][1];
+
+    return nextRow >= 0 && nextRow < MAP_ROWS &&
+           nextCol >= 0 && nextCol < MAP_COLS &&
+           map[nextRow][nextCol] != '#';
+}
+
+void maze_build(Maze *maze, const char map[MAP_ROWS][MAP_COLS], int8_t tunnelRow) {
+    const int8_t ghostStartPos[4][2] = {
+        {GHOST_HOME-3, GHOST_HOME},    // Blinky
+        {GHOST_HOME-1, GHOST_HOME},    // Pinky
+        {GHOST_HOME-1, GHOST_HOME-2},  // Inky
+        {GHOST_HOME-1, GHOST_HOME+2}   // Clyde
+    };
+
+    memset(maze, 0, sizeof(Maze));
+    memcpy(maze->map, map, sizeof(maze->map));
+    maze->tunnelRow = tunnelRow;
+    maze->pacmanStart[0] = PACMAN_START_ROW;
+    maze->pacmanStart[1] = PACMAN_START_COL;
+    memcpy(maze->ghostStart, ghostStartPos, sizeof(ghostStartPos));
+    maze->ghostHome[0] = GHOST_HOME;
+    maze->ghostHome[1] = GHOST_HOME;
+
+    for (int row = 0; row < MAP_ROWS; row++) {
+        for (int col = 0; col < MAP_COLS; col++) {
+            uint16_t tile = maze_tile(row, col);
+            maze->tileRow[tile] = row;
+            maze->tileCol[tile] = col;
+
+            switch (map[row][col]) {
+                case '#': bitboard_set(maze->walls, tile); break;
+                case 'o': bitboard_set(maze->orbs, tile); // fallthrough
+                case '.': bitboard_set(maze->dots, tile); break;
+                default: break;
+            }
+
+            for (int dir = 0; dir < DIR_COUNT; dir++) {
+                if (build_move(map, tunnelRow, row, col, dir, &maze->neighbour[tile][dir])) maze->moveMask[tile] |= 1 << dir;
+                if (build_chase(map, row, col, dir)) maze->chaseMask[tile] |= 1 << dir;
+            }
+        }
+    }
+
+    maze->dotCount = bitboard_count(maze->dots, MAZE_WORDS);
+}
+
+const Maze *maze_default(void) {
+    static Maze maze;
+    static CoreOnce once;
+
+    if (core_once_begin(&once)) {
+        maze_build(&maze, pacman_map, TUNNEL_ROW);
+        core_once_end(&once, true);
+    }
+    return &maze;
+}
@@ -0,0 +1,42 @@
+#ifndef PACMAN_CORE_ONCE_H
+#define PACMAN_CORE_ONCE_H
+
+/* Tables built on first use (maze_default(), paths_default(), the batch dot
+ * tables) may be first asked for from two threads at once, e.g. the --threaded
+ * sim thread and the main thread. The core has no thread library, so the
+ * flag is a GCC/Clang atomic; other compilers get a plain flag, and their
+ * callers must make the first call before starting threads. */
+
+#include <stdbool.h>
+
+typedef int CoreOnce; // zero initialised: not built yet
+
+enum {CORE_ONCE_IDLE, CORE_ONCE_RUNNING, CORE_ONCE_DONE};
+
+// True for the one caller that has to build, which then calls core_once_end().
+// Callers arriving while it builds wait here for it.
+static inline bool core_once_begin(CoreOnce *once) {
+#if defined(__GNUC__)
+    for (;;) {
+        int state = __atomic_load_n(once, __ATOMIC_ACQUIRE);
+        if (state == CORE_ONCE_DONE) return false;
+        if (state == CORE_ONCE_IDLE &&
+            __atomic_compare_exchange_n(once, &state, CORE_ONCE_RUNNING, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) return true;
+    }
+#else
+    if (*once == CORE_ONCE_DONE) return false;
+    *once = CORE_ONCE_RUNNING;
+    return true;
+#endif
+}
+
+// built false (out of memory) leaves the build to the next caller.
+static inline void core_once_end(CoreOnce *once, bool built) {
+#if defined(__GNUC__)
+    __atomic_store_n(once, built ? CORE_ONCE_DONE : CORE_ONCE_IDLE, __ATOMIC_RELEASE);
+#else
+    *once = built ? CORE_ONCE_DONE : CORE_ONCE_IDLE;
+#endif
+}
+
+#endif
@@ -0,0 +1,103 @@
+#include "paths.h"
+#include "core.h"
+#include "once.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Breadth first from one tile, dist[] indexed by tile.
+static void bfs_moves(const Maze *maze, uint16_t start, uint16_t *dist) {
+    uint16_t queue[MAZE_TILES];
+    int head = 0, tail = 0;
+
+    for (int i = 0; i < MAZE_TILES; i++) dist[i] = UINT16_MAX;
+    dist[start] = 0;
+    queue[tail++] = start;
+    while (head < tail) {
+        uint16_t tile = queue[head++];
+        for (int dir = 0; dir < DIR_COUNT; dir++) {
+            if (!((maze->moveMask[tile] >> dir) & 1)) continue;
+            uint16_t next = maze->neighbour[tile][dir];
+            if (dist[next] == UINT16_MAX) {
+                dist[next] = dist[tile] + 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+}
+
+// Multi-source flood over the whole grid, walls included, from every indexed tile.
+static void build_nearest(PathTable *paths) {
+    uint16_t queue[MAZE_TILES];
+    int head = 0, tail = 0;
+
+    for (int i = 0; i < MAZE_TILES; i++) paths->nearest[i] = PATHS_NO_INDEX;
+    for (uint16_t tile = 0; tile < MAZE_TILES; tile++) {
+        if (paths->tileIndex[tile] == PATHS_NO_INDEX) continue;
+        paths->nearest[tile] = paths->tileIndex[tile];
+        queue[tail++] = tile;
+    }
+
+    while (head < tail) {
+        uint16_t tile = queue[head++];
+        int row = tile / MAP_COLS, col = tile % MAP_COLS;
+        for (int dir = 0; dir < DIR_COUNT; dir++) {
+            int nextRow = row + directionOffsets[dir][0];
+            int nextCol = col + directionOffsets[dir][1];
+            if (nextRow < 0 || nextRow >= MAP_ROWS || nextCol < 0 || nextCol >= MAP_COLS) continue;
+
+            uint16_t next = maze_tile(nextRow, nextCol);
+            if (paths->nearest[next] == PATHS_NO_INDEX) {
+                paths->nearest[next] = paths->nearest[tile];
+                queue[tail++] = next;
+            }
+        }
+    }
+}
+
+bool paths_build(PathTable *paths, const Maze *maze, int8_t startRow, int8_t startCol) {
+    uint16_t dist[MAZE_TILES];
+
+    memset(paths, 0, sizeof(PathTable));
+    paths->maze = maze;
+
+    bfs_moves(maze, maze_tile(startRow, startCol), dist);
+    for (uint16_t tile = 0; tile < MAZE_TILES; tile++) {
+        paths->tileIndex[tile] = dist[tile] == UINT16_MAX ? PATHS_NO_INDEX : paths->count++;
+    }
+
+    paths->steps = malloc((size_t)paths->count * paths->count);
+    if (!paths->steps) return false;
+
+    for (uint16_t from = 0; from < MAZE_TILES; from++) {
+        uint16_t fromIndex = paths->tileIndex[from];
+        if (fromIndex == PATHS_NO_INDEX) continue;
+
+        bfs_moves(maze, from, dist);
+        for (uint16_t to = 0; to < MAZE_TILES; to++) {
+            uint16_t toIndex = paths->tileIndex[to];
+            if (toIndex == PATHS_NO_INDEX) continue;
+            paths->steps[(uint32_t)toIndex * paths->count + fromIndex] = dist[to] < PATHS_FAR ? dist[to] : PATHS_FAR;
+        }
+    }
+
+    build_nearest(paths);
+    return true;
+}
+
+void paths_free(PathTable *paths) {
+    free(paths->steps);
+    paths->steps = NULL;
+}
+
+const PathTable *paths_default(void) {
+    static PathTable paths;
+    static CoreOnce once;
+
+    if (core_once_begin(&once)) {
+        const Maze *maze = maze_default();
+        bool built = paths_build(&paths, maze, maze->pacmanStart[0], maze->pacmanStart[1]);
+        core_once_end(&once, built);
+        if (!built) return NULL;
+    }
+    return &paths;
+}
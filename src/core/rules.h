@@ -0,0 +1,161 @@
+#ifndef PACMAN_CORE_RULES_H
+#define PACMAN_CORE_RULES_H
+
+/* Movement and ghost AI rules shared by every simulator in src/core
+ * (GameLogic and the batched engine), so they cannot drift apart.
+ * Walls never change during a level, so moves are Maze table lookups. */
+
+#include "core.h"
+#include "paths.h"
+#include <stdlib.h>
+
+// xorshift32, so every game carries its own reproducible random stream.
+static inline uint32_t rules_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Index of the lowest set bit, mask must be non zero.
+static inline int rules_lowest_bit(uint64_t mask) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(mask);
+#else
+    int i = 0;
+    while (!(mask & 1)) { mask >>= 1; i++; }
+    return i;
+#endif
+}
+
+static inline Direction rules_reverse(Direction dir) {
+    return (dir + 2) % DIR_COUNT;
+}
+
+// core_try_move() without the commit: where an entity ends up, tunnel included.
+static inline bool rules_next_tile(const Maze *maze, int8_t row, int8_t col, Direction dir, int8_t *outRow, int8_t *outCol) {
+    uint16_t tile = maze_tile(row, col);
+    if (!((maze->moveMask[tile] >> dir) & 1)) return false;
+
+    uint16_t next = maze->neighbour[tile][dir];
+    *outRow = maze->tileRow[next];
+    *outCol = maze->tileCol[next];
+    return true;
+}
+
+static inline uint16_t rules_ghost_ticks(int ghost, bool scared, uint8_t dotsEaten) {
+    return scared ? GHOST_FRIGHTENED_TICKS : ghostBaseTicks[ghost]-CORE_MS(dotsEaten >> 3);
+}
+
+static inline void rules_ghost_target(EntityKind kind, int8_t ghostRow, int8_t ghostCol,
+                                      int8_t pacRow, int8_t pacCol, Direction pacDir,
+                                      int8_t blinkyRow, int8_t blinkyCol,
+                                      int8_t *outRow, int8_t *outCol) {
+    int8_t targetRow = pacRow;
+    int8_t targetCol = pacCol;
+
+    switch (kind) {
+        case TYPE_PINKY: // Pinky - targets 4 tiles ahead of Pacman
+            targetRow += directionOffsets[pacDir][0] << 2;
+            targetCol += directionOffsets[pacDir][1] << 2;
+
+            // Special case for up direction (original Pacman bug)
+            if (pacDir == DIR_UP) targetCol -= 4;
+            break;
+
+        case TYPE_INKY:{ // Inky - uses Blinky's position to calculate target
+            int8_t pacAheadRow = pacRow + (directionOffsets[pacDir][0] << 1);
+            int8_t pacAheadCol = pacCol + (directionOffsets[pacDir][1] << 1);
+
+            targetRow = pacAheadRow + (pacAheadRow - blinkyRow); // less blinky position.
+            targetCol = pacAheadCol + (pacAheadCol - blinkyCol);
+            break;
+        }
+        case TYPE_CLYDE: // Clyde - scatters if close to Pacman
+            if (abs(pacCol - ghostCol) + abs(pacRow - ghostRow) <= 8) {
+                targetRow = MAP_ROWS - 1;
+                targetCol = 0;
+            }
+            break;
+        default: // Blinky - chases directly
+            break;
+    }
+
+    *outRow = targetRow;
+    *outCol = targetCol;
+}
+
+// Corridor tiles leave at most one non-reverse candidate, so the target
+// cannot change the choice and does not need computing.
+static inline bool rules_forced_dir(const Maze *maze, int8_t row, int8_t col, Direction current, Direction *out) {
+    uint8_t candidates = maze->chaseMask[maze_tile(row, col)] & ~(1 << rules_reverse(current));
+    if (candidates & (candidates - 1)) return false;
+
+    *out = candidates ? (Direction)rules_lowest_bit(candidates) : rules_reverse(current);
+    return true;
+}
+
+static inline Direction rules_chase_dir(const Maze *maze, int8_t row, int8_t col, Direction current, int8_t targetRow, int8_t targetCol) {
+    Direction bestDir = DIR_COUNT;
+    uint16_t bestDistance = UINT16_MAX;
+
+    // Legal directions, excluding reverse of current direction
+    uint8_t candidates = maze->chaseMask[maze_tile(row, col)] & ~(1 << rules_reverse(current));
+    for (Direction dir = 0; dir < DIR_COUNT; dir++) {
+        if (!((candidates >> dir) & 1)) continue;
+
+        int8_t nextRow = row + directionOffsets[dir][0];
+        int8_t nextCol = col + directionOffsets[dir][1];
+        uint16_t distance = (targetCol - nextCol) * (targetCol - nextCol) +
+                           (targetRow - nextRow) * (targetRow - nextRow);
+
+        // Directions are sorted in priority order, so the first minimum wins ties.
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            bestDir = dir;
+        }
+    }
+
+    return bestDir == DIR_COUNT ? rules_reverse(current) : bestDir;
+}
+
+// Path targeting: same candidates and tie order as rules_chase_dir(), scored
+// by steps through the maze instead of straight-line distance. Ghosts off the
+// table (still inside the house walls) fall back to the classic rule.
+static inline Direction rules_path_dir(const Maze *maze, const PathTable *paths, int8_t row, int8_t col, Direction current, int8_t targetRow, int8_t targetCol) {
+    uint16_t tile = maze_tile(row, col);
+    if (paths->tileIndex[tile] == PATHS_NO_INDEX) return rules_chase_dir(maze, row, col, current, targetRow, targetCol);
+
+    uint16_t target = paths_target(paths, targetRow, targetCol);
+    Direction bestDir = DIR_COUNT;
+    uint16_t bestSteps = UINT16_MAX;
+
+    uint8_t candidates = maze->chaseMask[tile] & ~(1 << rules_reverse(current));
+    for (Direction dir = 0; dir < DIR_COUNT; dir++) {
+        if (!((candidates >> dir) & 1)) continue;
+
+        uint16_t next = paths->tileIndex[maze->neighbour[tile][dir]];
+        uint16_t steps = next == PATHS_NO_INDEX ? PATHS_FAR + 1 : paths_steps(paths, next, target);
+        if (steps < bestSteps) {
+            bestSteps = steps;
+            bestDir = dir;
+        }
+    }
+
+    return bestDir == DIR_COUNT ? rules_reverse(current) : bestDir;
+}
+
+// Frightened ghosts wander: random start, first legal non-reverse direction, else reverse.
+static inline Direction rules_random_dir(const Maze *maze, int8_t row, int8_t col, Direction current, uint32_t *rng) {
+    uint8_t legal = maze->moveMask[maze_tile(row, col)];
+    Direction dir = rules_rand(rng) % DIR_COUNT;
+    for (uint8_t attempts = 0; attempts < DIR_COUNT; attempts++) {
+        if (dir != rules_reverse(current) && ((legal >> dir) & 1)) return dir;
+        dir = (dir + 1) % DIR_COUNT;
+    }
+    return rules_reverse(current);
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include "core.h"
+#include "rules.h"
+
+/* Event-driven stepping for GameLogic. Between two moves a tick only adds
+ * DELTA_TICK to five move timers and takes it off the hunter timer; the
+ * board, the RNG and the collision state do not change. So the ticks until
+ * the next timer fires are computed up front, those no-op ticks are applied
+ * in one go, and core_step() only runs on ticks where something happens.
+ *
+ * The firing thresholds only change on event ticks (dots eaten, scared flags),
+ * never inside a skipped window. Six timers is small enough that a linear
+ * scan for the soonest one beats keeping a heap or a timing wheel. */
+
+// Ticks until a timer reaches its threshold, counting the tick that fires it.
+static uint32_t ticks_until(uint16_t timer, uint16_t threshold) {
+    if (timer >= threshold) return 1;
+    return (threshold - timer + DELTA_TICK - 1) / DELTA_TICK;
+}
+
+static uint32_t next_event(const GameLogic *game) {
+    uint32_t next = ticks_until(game->player.pacman.moveTimer, BASE_TICKS);
+
+    for (int i = 0; i < 4; i++) {
+        const GameEntity *ghost = &game->ghosts[i];
+        uint32_t ticks = ticks_until(ghost->moveTimer, rules_ghost_ticks(i, ghost->scared, game->player.dotsEaten));
+        if (ticks < next) next = ticks;
+    }
+
+    if (game->player.hunterTime > 0) {
+        uint32_t ticks = ticks_until(0, game->player.hunterTime);
+        if (ticks < next) next = ticks;
+    }
+    return next;
+}
+
+// Applies ticks that are known not to fire any timer.
+static void skip_ticks(GameLogic *game, uint32_t ticks) {
+    uint16_t elapsed = (uint16_t)(ticks * DELTA_TICK);
+
+    game->player.pacman.moveTimer += elapsed;
+    for (int i = 0; i < 4; i++) game->ghosts[i].moveTimer += elapsed;
+    if (game->player.hunterTime > 0) game->player.hunterTime -= elapsed;
+}
+
+uint32_t core_advance(GameLogic *game, uint32_t maxTicks, Direction input, uint32_t stopEvents, uint32_t *ticksDone) {
+    uint32_t events = CORE_EVENT_NONE;
+    uint32_t done = 0;
+
+    if (game->state == STATE_PLAYING && maxTicks > 0) {
+        // The first tick is always a full step: it applies the input and
+        // settles any state the caller changed since the last call.
+        events |= core_step(game, input);
+        done++;
+
+        while (done < maxTicks && game->state == STATE_PLAYING && !(events & stopEvents)) {
+            uint32_t ticks = next_event(game);
+            if (ticks > maxTicks - done) {
+                skip_ticks(game, maxTicks - done);
+                game->events = CORE_EVENT_NONE;
+                done = maxTicks;
+                break;
+            }
+
+            skip_ticks(game, ticks - 1);
+            events |= core_step(game, DIR_COUNT);
+            done += ticks;
+        }
+    }
+
+    if (ticksDone) *ticksDone = done;
+    return events;
+}
@@ -0,0 +1,17 @@
+#ifndef PACMAN_CORE_STEP_H
+#define PACMAN_CORE_STEP_H
+
+/* The parts core_step() runs each tick, exported from core.c so
+ * bench/bench_sim.c can time them one by one against the library. Not part
+ * of include/core.h: they skip the state checks core_step() makes first. */
+
+#include "core.h"
+
+// Moves entity one tile in dir, tunnel included. False when a wall is in the way.
+bool core_try_move(GameLogic *game, GameEntity *entity, Direction dir);
+// Bumps the ghost timers and moves every ghost that is due.
+void core_update_ghosts(GameLogic *game);
+// Pacman against every ghost on his tile. True when he lost a life.
+bool core_check_collisions(GameLogic *game);
+
+#endif
@@ -0,0 +1,313 @@
+#include "swarm.h"
+#include "rules.h"
+#include "carve.h"
+#include <stdlib.h>
+#include <string.h>
+
+static size_t carve_all(Swarm *swarm, uint8_t *base) {
+    uint8_t *cur = base;
+    uint32_t n = swarm->ghostCount;
+
+    swarm->ghostTile   = carve(&cur, n * sizeof(uint16_t));
+    swarm->ghostSpawn  = carve(&cur, n * sizeof(uint16_t));
+    swarm->ghostTimer  = carve(&cur, n * sizeof(uint16_t));
+    swarm->ghostDir    = carve(&cur, n);
+    swarm->ghostScared = carve(&cur, n);
+    swarm->ghostNext   = carve(&cur, n * sizeof(uint32_t));
+    swarm->ghostPrev   = carve(&cur, n * sizeof(uint32_t));
+    return (size_t)(cur - base);
+}
+
+static void build_predecessors(Swarm *swarm) {
+    const Maze *maze = swarm->maze;
+    uint16_t count[MAZE_TILES + 1] = {0};
+
+    for (uint16_t tile = 0; tile < MAZE_TILES; tile++) {
+        for (int dir = 0; dir < DIR_COUNT; dir++) {
+            if ((maze->moveMask[tile] >> dir) & 1) count[maze->neighbour[tile][dir]]++;
+        }
+    }
+    swarm->predStart[0] = 0;
+    for (uint16_t tile = 0; tile < MAZE_TILES; tile++) {
+        swarm->predStart[tile + 1] = swarm->predStart[tile] + count[tile];
+        count[tile] = swarm->predStart[tile];
+    }
+    for (uint16_t tile = 0; tile < MAZE_TILES; tile++) {
+        for (int dir = 0; dir < DIR_COUNT; dir++) {
+            if ((maze->moveMask[tile] >> dir) & 1) swarm->pred[count[maze->neighbour[tile][dir]]++] = tile;
+        }
+    }
+}
+
+// Breadth first from Pacman over reversed moves: flow[t] is how far t is from him.
+static void build_flow(Swarm *swarm, uint16_t target) {
+    uint16_t queue[MAZE_TILES];
+    int head = 0, tail = 0;
+
+    memset(swarm->flow, PATHS_FAR, sizeof(swarm->flow));
+    swarm->flow[target] = 0;
+    queue[tail++] = target;
+    while (head < tail) {
+        uint16_t tile = queue[head++];
+        uint8_t steps = swarm->flow[tile] + 1;
+        if (steps == PATHS_FAR) continue;
+
+        for (uint16_t p = swarm->predStart[tile]; p < swarm->predStart[tile + 1]; p++) {
+            uint16_t prev = swarm->pred[p];
+            if (swarm->flow[prev] == PATHS_FAR) {
+                swarm->flow[prev] = steps;
+                queue[tail++] = prev;
+            }
+        }
+    }
+    swarm->flowTile = target;
+    swarm->flowBuilds++;
+}
+
+static void link_ghost(Swarm *swarm, uint32_t g, uint16_t tile) {
+    uint32_t head = swarm->tileHead[tile];
+    swarm->ghostTile[g] = tile;
+    swarm->ghostPrev[g] = SWARM_NONE;
+    swarm->ghostNext[g] = head;
+    if (head != SWARM_NONE) swarm->ghostPrev[head] = g;
+    swarm->tileHead[tile] = g;
+}
+
+static void unlink_ghost(Swarm *swarm, uint32_t g) {
+    uint32_t prev = swarm->ghostPrev[g], next = swarm->ghostNext[g];
+    if (prev != SWARM_NONE) swarm->ghostNext[prev] = next;
+    else swarm->tileHead[swarm->ghostTile[g]] = next;
+    if (next != SWARM_NONE) swarm->ghostPrev[next] = prev;
+}
+
+static void reset_positions(Swarm *swarm) {
+    swarm->player.pacman.row = swarm->maze->pacmanStart[0];
+    swarm->player.pacman.col = swarm->maze->pacmanStart[1];
+    swarm->player.pacman.dir = DIR_UP;
+    swarm->player.hunterTime = 0;
+    swarm->player.ghostCombo = 1;
+
+    for (uint16_t tile = 0; tile < MAZE_TILES; tile++) swarm->tileHead[tile] = SWARM_NONE;
+    for (uint32_t g = 0; g < swarm->ghostCount; g++) {
+        swarm->ghostScared[g] = false;
+        swarm->ghostDir[g] = DIR_UP;
+        link_ghost(swarm, g, swarm->ghostSpawn[g]);
+    }
+}
+
+static void init_level(Swarm *swarm, bool levelWon) {
+    if (levelWon) {
+        swarm->player.dotsEaten = 0;
+        if (swarm->player.lives < 3) swarm->player.lives++;
+        swarm->player.rewardCount++;
+    } else {
+        swarm->player.score = 0;
+        swarm->player.lives = 3;
+        swarm->player.rewardCount = 1;
+        swarm->player.dotsEaten = 0;
+    }
+
+    reset_positions(swarm);
+    memcpy(swarm->dots, swarm->maze->dots, sizeof(swarm->dots));
+}
+
+void swarm_new_game(Swarm *swarm) {
+    swarm->player.pacman.moveTimer = 0;
+    for (uint32_t g = 0; g < swarm->ghostCount; g++) swarm->ghostTimer[g] = 0;
+    init_level(swarm, false);
+    swarm->state = STATE_PLAYING;
+}
+
+bool swarm_init(Swarm *swarm, uint32_t ghostCount, uint32_t seed) {
+    memset(swarm, 0, sizeof(Swarm));
+    swarm->maze = maze_default();
+    swarm->rng = seed ? seed : 0x9E3779B9u; // same fallback as core_init()
+    if (ghostCount == 0) return false;
+
+    swarm->ghostCount = ghostCount;
+    size_t bytes = carve_all(swarm, NULL);
+    swarm->block = calloc(1, bytes + CARVE_SLACK);
+    if (!swarm->block) {
+        swarm->ghostCount = 0;
+        return false;
+    }
+    carve_all(swarm, carve_base(swarm->block));
+    build_predecessors(swarm);
+
+    // Spawn tiles: anywhere Pacman can reach, but not right next to his start
+    uint16_t spawnable[MAZE_TILES];
+    uint16_t spawnCount = 0;
+    build_flow(swarm, maze_tile(swarm->maze->pacmanStart[0], swarm->maze->pacmanStart[1]));
+    for (uint16_t tile = 0; tile < MAZE_TILES; tile++) {
+        if (swarm->flow[tile] != PATHS_FAR && swarm->flow[tile] >= SWARM_SPAWN_DISTANCE) spawnable[spawnCount++] = tile;
+    }
+    if (spawnCount < 2) {
+        swarm_free(swarm);
+        return false;
+    }
+    for (uint32_t g = 0; g < ghostCount; g++) swarm->ghostSpawn[g] = spawnable[rules_rand(&swarm->rng) % spawnCount];
+    swarm->spareSpawn[0] = spawnable[0];
+    swarm->spareSpawn[1] = spawnable[spawnCount - 1];
+
+    swarm_new_game(swarm);
+    return true;
+}
+
+void swarm_free(Swarm *swarm) {
+    free(swarm->block);
+    memset(swarm, 0, sizeof(Swarm));
+}
+
+// An eaten ghost put back on Pacman's own tile, unscared, would kill him on the next check.
+static uint16_t respawn_tile(const Swarm *swarm, uint32_t g, uint16_t pacTile) {
+    if (swarm->ghostSpawn[g] != pacTile) return swarm->ghostSpawn[g];
+    return swarm->spareSpawn[0] != pacTile ? swarm->spareSpawn[0] : swarm->spareSpawn[1];
+}
+
+static bool check_collisions(Swarm *swarm) {
+    GameEntity *pacman = &swarm->player.pacman;
+    uint16_t pacTile = maze_tile(pacman->row, pacman->col);
+    uint32_t g = swarm->tileHead[pacTile];
+
+    while (g != SWARM_NONE) {
+        uint32_t next = swarm->ghostNext[g];
+        if (swarm->player.hunterTime > 0 && swarm->ghostScared[g]) {
+            // Pacman eats ghost, it starts over from its spawn tile
+            swarm->player.score += swarm->player.ghostCombo * HUNTER_SCORE_MULTIPLIER;
+            swarm->player.ghostCombo++;
+            unlink_ghost(swarm, g);
+            link_ghost(swarm, g, respawn_tile(swarm, g, pacTile));
+            swarm->ghostScared[g] = false;
+            swarm->events |= CORE_EVENT_EAT_GHOST | CORE_EVENT_SCORE;
+        } else {
+            if (--swarm->player.lives == 0) {
+                swarm->state = STATE_GAME_OVER;
+                swarm->events |= CORE_EVENT_GAME_OVER;
+            } else {
+                swarm->state = STATE_LIFE_LOST;
+                swarm->events |= CORE_EVENT_LIFE_LOST;
+            }
+            return true;
+        }
+        g = next;
+    }
+    return false;
+}
+
+static void update_hunter(Swarm *swarm) {
+    if (swarm->player.hunterTime <= 0) return;
+
+    swarm->player.hunterTime -= DELTA_TICK;
+    if (swarm->player.hunterTime <= 0) {
+        swarm->player.hunterTime = 0;
+        memset(swarm->ghostScared, 0, swarm->ghostCount);
+        swarm->events |= CORE_EVENT_HUNTER_END;
+    }
+}
+
+// Downhill on the flow field; ties go to the first direction, like rules_chase_dir().
+static Direction flow_dir(const Swarm *swarm, uint16_t tile, Direction current) {
+    const Maze *maze = swarm->maze;
+    Direction bestDir = DIR_COUNT;
+    uint8_t bestSteps = UINT8_MAX;
+
+    uint8_t candidates = maze->moveMask[tile] & ~(1 << rules_reverse(current));
+    while (candidates) {
+        Direction dir = rules_lowest_bit(candidates);
+        candidates &= candidates - 1;
+
+        uint8_t steps = swarm->flow[maze->neighbour[tile][dir]];
+        if (steps < bestSteps) {
+            bestSteps = steps;
+            bestDir = dir;
+        }
+    }
+    return bestDir == DIR_COUNT ? rules_reverse(current) : bestDir;
+}
+
+static void update_ghosts(Swarm *swarm) {
+    const Maze *maze = swarm->maze;
+    bool hunting = swarm->player.hunterTime != 0;
+    uint16_t chaseTicks[4];
+
+    for (int kind = 0; kind < 4; kind++) chaseTicks[kind] = rules_ghost_ticks(kind, false, swarm->player.dotsEaten);
+
+    for (uint32_t g = 0; g < swarm->ghostCount; g++) {
+        uint16_t required = swarm->ghostScared[g] ? GHOST_FRIGHTENED_TICKS : chaseTicks[g & 3];
+        swarm->ghostTimer[g] += DELTA_TICK;
+        if (swarm->ghostTimer[g] < required) continue;
+        swarm->ghostTimer[g] = 0;
+
+        uint16_t tile = swarm->ghostTile[g];
+        Direction dir = swarm->ghostDir[g];
+        if (!swarm->ghostScared[g] || !hunting) {
+            dir = flow_dir(swarm, tile, dir);
+        } else {
+            dir = rules_random_dir(maze, maze->tileRow[tile], maze->tileCol[tile], dir, &swarm->rng);
+        }
+
+        if (!((maze->moveMask[tile] >> dir) & 1)) continue;
+        unlink_ghost(swarm, g);
+        link_ghost(swarm, g, maze->neighbour[tile][dir]);
+        swarm->ghostDir[g] = dir;
+    }
+}
+
+static void update_pacman(Swarm *swarm) {
+    GameEntity *pacman = &swarm->player.pacman;
+    pacman->moveTimer += DELTA_TICK;
+    if (pacman->moveTimer < BASE_TICKS) return;
+
+    pacman->moveTimer = 0;
+    if (!rules_next_tile(swarm->maze, pacman->row, pacman->col, pacman->dir, &pacman->row, &pacman->col)) return;
+    if (check_collisions(swarm)) return;
+
+    uint16_t tile = maze_tile(pacman->row, pacman->col);
+    if (!bitboard_test(swarm->dots, tile)) return;
+
+    bitboard_clear(swarm->dots, tile);
+    swarm->player.dotsEaten++;
+    if (bitboard_test(swarm->maze->orbs, tile)) {
+        swarm->player.hunterTime = HUNTER_MODE_DURATION;
+        swarm->player.score += 50;
+        swarm->player.ghostCombo = 1;
+        memset(swarm->ghostScared, 1, swarm->ghostCount);
+        swarm->events |= CORE_EVENT_EAT_ORB | CORE_EVENT_SCORE;
+    } else {
+        swarm->player.score += 10;
+        swarm->events |= CORE_EVENT_EAT_DOT | CORE_EVENT_SCORE;
+    }
+
+    // Level completion check
+    if (bitboard_empty(swarm->dots, MAZE_WORDS)) {
+        if (swarm->player.rewardCount == 9) {
+            swarm->state = STATE_GAME_COMPLETE;
+            swarm->events |= CORE_EVENT_GAME_COMPLETE;
+        } else {
+            init_level(swarm, true);
+            swarm->events |= CORE_EVENT_LEVEL_COMPLETE;
+        }
+    }
+}
+
+uint32_t swarm_step(Swarm *swarm, Direction input) {
+    GameEntity *pacman = &swarm->player.pacman;
+    swarm->events = CORE_EVENT_NONE;
+    if (input < DIR_COUNT) pacman->dir = input;
+
+    // One field for every chasing ghost, only rebuilt when Pacman changed tile
+    uint16_t pacTile = maze_tile(pacman->row, pacman->col);
+    if (pacTile != swarm->flowTile) build_flow(swarm, pacTile);
+
+    update_hunter(swarm);
+    update_ghosts(swarm);
+    if (!check_collisions(swarm)) update_pacman(swarm);
+
+    if (swarm->state == STATE_LIFE_LOST) {
+        reset_positions(swarm);
+        swarm->state = STATE_PLAYING;
+    } else if (swarm->state != STATE_PLAYING) {
+        swarm_new_game(swarm);
+    }
+    return swarm->events;
+}
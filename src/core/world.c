@@ -0,0 +1,151 @@
+#include "world.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Generator: a binary-tree maze on the odd tiles. Cell (i, j) sits at tile
+ * (2i+1, 2j+1) and opens its north or east wall, chosen by a hash of
+ * (seed, i, j); one cell in four opens both, which braids in the loops a
+ * Pacman maze needs. No cell looks at another, hence the lazy chunks. */
+
+static uint32_t cell_hash(uint32_t seed, int32_t i, int32_t j) {
+    uint32_t h = seed ^ (uint32_t)i * 0x9E3779B1u ^ (uint32_t)j * 0x85EBCA77u;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+static bool cell_opens_north(const World *world, int32_t i, int32_t j) {
+    int32_t cellCols = world->cols >> 1;
+    if (i == 0) return false;
+    if (j == cellCols - 1) return true;
+
+    uint32_t h = cell_hash(world->seed, i, j);
+    return (h & 1) || ((h >> 1) & 3) == 0;
+}
+
+static bool cell_opens_east(const World *world, int32_t i, int32_t j) {
+    int32_t cellCols = world->cols >> 1;
+    if (j >= cellCols - 1) return false;
+    if (i == 0) return true;
+
+    uint32_t h = cell_hash(world->seed, i, j);
+    return !(h & 1) || ((h >> 1) & 3) == 0;
+}
+
+static bool generate_wall(const World *world, int32_t row, int32_t col) {
+    if (row <= 0 || col <= 0 || row >= world->rows - 1 || col >= world->cols - 1) return true;
+
+    bool oddRow = row & 1, oddCol = col & 1;
+    if (oddRow && oddCol) return false;   // cell
+    if (!oddRow && !oddCol) return true;  // pillar
+    if (oddCol) return !cell_opens_north(world, row >> 1, col >> 1);
+    return !cell_opens_east(world, row >> 1, (col >> 1) - 1);
+}
+
+bool world_init(World *world, int32_t rows, int32_t cols, uint32_t seed) {
+    memset(world, 0, sizeof(World));
+    if (rows < WORLD_MIN_SIDE) rows = WORLD_MIN_SIDE;
+    if (cols < WORLD_MIN_SIDE) cols = WORLD_MIN_SIDE;
+    if (rows > WORLD_MAX_SIDE) rows = WORLD_MAX_SIDE;
+    if (cols > WORLD_MAX_SIDE) cols = WORLD_MAX_SIDE;
+
+    world->seed = seed;
+    world->rows = rows | 1;
+    world->cols = cols | 1;
+    world->chunkRows = (world->rows + WORLD_CHUNK - 1) / WORLD_CHUNK;
+    world->chunkCols = (world->cols + WORLD_CHUNK - 1) / WORLD_CHUNK;
+    world->chunks = calloc((size_t)world->chunkRows * world->chunkCols, sizeof(WorldChunk *));
+    if (!world->chunks) return false;
+
+    // Start on the cell nearest the middle
+    world->pacRow = ((world->rows >> 2) << 1) + 1;
+    world->pacCol = ((world->cols >> 2) << 1) + 1;
+    world->pacDir = DIR_RIGHT;
+    return true;
+}
+
+void world_free(World *world) {
+    if (world->chunks) {
+        for (int32_t i = 0; i < world->chunkRows * world->chunkCols; i++) free(world->chunks[i]);
+        free(world->chunks);
+    }
+    memset(world, 0, sizeof(World));
+}
+
+WorldChunk *world_chunk(World *world, int32_t chunkRow, int32_t chunkCol) {
+    WorldChunk **slot = &world->chunks[chunkRow * world->chunkCols + chunkCol];
+    if (*slot) return *slot;
+
+    WorldChunk *chunk = malloc(sizeof(WorldChunk));
+    if (!chunk) return NULL;
+
+    int32_t baseRow = chunkRow * WORLD_CHUNK, baseCol = chunkCol * WORLD_CHUNK;
+    for (int r = 0; r < WORLD_CHUNK; r++) {
+        uint32_t walls = 0;
+        for (int c = 0; c < WORLD_CHUNK; c++) {
+            if (generate_wall(world, baseRow + r, baseCol + c)) walls |= 1u << c;
+        }
+        chunk->walls[r] = walls;
+        chunk->dots[r] = ~walls; // every open tile starts with a dot
+    }
+
+    *slot = chunk;
+    world->chunksBuilt++;
+    return chunk;
+}
+
+bool world_is_wall(World *world, int32_t row, int32_t col) {
+    if (row < 0 || col < 0 || row >= world->rows || col >= world->cols) return true;
+
+    WorldChunk *chunk = world_chunk(world, row / WORLD_CHUNK, col / WORLD_CHUNK);
+    if (!chunk) return generate_wall(world, row, col);
+    return (chunk->walls[row % WORLD_CHUNK] >> (col % WORLD_CHUNK)) & 1;
+}
+
+uint32_t world_step(World *world, Direction input) {
+    world->events = CORE_EVENT_NONE;
+    if (input < DIR_COUNT) world->pacDir = input;
+
+    world->pacTimer += DELTA_TICK;
+    if (world->pacTimer < BASE_TICKS) return world->events;
+    world->pacTimer = 0;
+
+    int32_t nextRow = world->pacRow + directionOffsets[world->pacDir][0];
+    int32_t nextCol = world->pacCol + directionOffsets[world->pacDir][1];
+    if (world_is_wall(world, nextRow, nextCol)) return world->events;
+    world->pacRow = nextRow;
+    world->pacCol = nextCol;
+
+    WorldChunk *chunk = world_chunk(world, nextRow / WORLD_CHUNK, nextCol / WORLD_CHUNK);
+    uint32_t bit = 1u << (nextCol % WORLD_CHUNK);
+    if (chunk && (chunk->dots[nextRow % WORLD_CHUNK] & bit)) {
+        chunk->dots[nextRow % WORLD_CHUNK] &= ~bit;
+        world->dotsEaten++;
+        world->score += 10;
+        world->events |= CORE_EVENT_EAT_DOT | CORE_EVENT_SCORE;
+    }
+    return world->events;
+}
+
+static int32_t clamp_camera(int32_t centre, int32_t view, int32_t size) {
+    int32_t first = centre - (view >> 1);
+    if (first > size - view) first = size - view;
+    return first < 0 ? 0 : first;
+}
+
+void world_view(const World *world, int32_t viewRows, int32_t viewCols, WorldView *view) {
+    view->firstRow = clamp_camera(world->pacRow, viewRows, world->rows);
+    view->firstCol = clamp_camera(world->pacCol, viewCols, world->cols);
+    view->lastRow = view->firstRow + viewRows - 1;
+    view->lastCol = view->firstCol + viewCols - 1;
+    if (view->lastRow >= world->rows) view->lastRow = world->rows - 1;
+    if (view->lastCol >= world->cols) view->lastCol = world->cols - 1;
+
+    view->firstChunkRow = view->firstRow / WORLD_CHUNK;
+    view->firstChunkCol = view->firstCol / WORLD_CHUNK;
+    view->lastChunkRow = view->lastRow / WORLD_CHUNK;
+    view->lastChunkCol = view->lastCol / WORLD_CHUNK;
+}
@@ -0,0 +1,35 @@
+#ifndef PACMAN_GAME_H
+#define PACMAN_GAME_H
+
+/* Internals of src/pacman.c that src/main.c and bench/bench_render.c call
+ * besides the entry points of include/pacman.h: one render function per
+ * screen, what render() does around them, and the startup error exit.
+ * Not an interface for anything outside the game. */
+
+#include "pacman.h"
+
+// Shows the error (a message box once video is up), waits for the startup workers, quits, exits.
+void show_error_and_quit(const char *title, const char *msg, AppContext *app);
+
+// After positions were reset (new level, new life): nothing slides in from the old ones.
+void reset_motion(AppContext *app);
+// --threaded, once per frame: hands the game to the sim thread and back, picks up its snapshots.
+void sync_sim(AppContext *app);
+
+// What render() draws for each state; entering is true on the first frame of a state.
+void render_menu_state(AppContext *app);
+void render_help_state(AppContext *app);
+void render_ranking_state(AppContext *app);
+void render_enter_name_state(AppContext *app);
+void render_start_level_state(AppContext *app, bool entering);
+void render_playing_state(AppContext *app, bool present);
+void render_paused_state(AppContext *app);
+void render_life_lost_state(AppContext *app, bool entering);
+void render_game_over_state(AppContext *app, bool entering);
+void render_game_complete_state(AppContext *app, bool entering);
+
+// The ScreenAsset bits a state shows, and loading those while releasing the rest.
+uint8_t screen_assets(GameState state);
+void hold_screen_assets(AppContext *app, uint8_t want);
+
+#endif
@@ -0,0 +1,101 @@
+#include "glyphs.h"
+#include <string.h>
+
+// Antialiased edges by default. Built with -DGLYPH_SOLID, as bench_render is,
+// glyphs are rasterised on/off with mono hinting: no coverage ramp to blend,
+// so the text in its golden frames comes out of the font file alone.
+#ifdef GLYPH_SOLID
+#define GLYPH_HINTING TTF_HINTING_MONO
+#define render_glyph TTF_RenderGlyph_Solid
+#else
+#define GLYPH_HINTING TTF_HINTING_NORMAL
+#define render_glyph TTF_RenderGlyph_Blended
+#endif
+
+// Characters outside the atlas show as '?'.
+static int glyph_index(char ch) {
+    unsigned char c = (unsigned char)ch;
+    return (c >= GLYPH_FIRST && c <= GLYPH_LAST ? c : '?') - GLYPH_FIRST;
+}
+
+bool glyph_atlas_build(GlyphAtlas *atlas, SDL_Renderer *renderer, TTF_Font *font, const uint8_t *sizes, int sizeCount) {
+    const SDL_Color white = {255, 255, 255, 255};
+    int x = 0, y = 0, rowH = 0;
+
+    memset(atlas, 0, sizeof(GlyphAtlas));
+    if (sizeCount > GLYPH_MAX_SIZES) return false;
+    atlas->sizeCount = sizeCount;
+    TTF_SetFontHinting(font, GLYPH_HINTING);
+
+    // Pass 1: measure and place every cell, rows wrap at the atlas width
+    for (int s = 0; s < sizeCount; s++) {
+        if (TTF_SetFontSize(font, sizes[s]) != 0) return false;
+        atlas->height[s] = TTF_FontHeight(font);
+        for (int g = 0; g < GLYPH_COUNT; g++) {
+            char str[2] = {(char)(GLYPH_FIRST + g), '\0'};
+            int w = 0, h = 0;
+            if (TTF_SizeText(font, str, &w, &h) != 0) return false;
+            if (x + w > GLYPH_ATLAS_WIDTH) {
+                x = 0;
+                y += rowH;
+                rowH = 0;
+            }
+            atlas->cell[s][g] = (SDL_Rect){x, y, w, h};
+            x += w;
+            if (h > rowH) rowH = h;
+        }
+    }
+
+    SDL_Surface *pixels = SDL_CreateRGBSurfaceWithFormat(0, GLYPH_ATLAS_WIDTH, y + rowH, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!pixels) return false;
+    SDL_FillRect(pixels, NULL, 0);
+
+    // Pass 2: rasterise each glyph into its cell, coverage kept in alpha
+    bool ok = true;
+    for (int s = 0; s < sizeCount && ok; s++) {
+        TTF_SetFontSize(font, sizes[s]);
+        for (int g = 0; g < GLYPH_COUNT && ok; g++) {
+            if (GLYPH_FIRST + g == ' ') continue;
+            SDL_Surface *glyph = render_glyph(font, (Uint16)(GLYPH_FIRST + g), white);
+            if (!glyph) {
+                ok = false;
+                break;
+            }
+            SDL_Rect src = {0, 0, atlas->cell[s][g].w, atlas->cell[s][g].h};
+            SDL_Rect dst = atlas->cell[s][g];
+            SDL_SetSurfaceBlendMode(glyph, SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(glyph, &src, pixels, &dst);
+            SDL_FreeSurface(glyph);
+        }
+    }
+
+    if (ok) atlas->texture = SDL_CreateTextureFromSurface(renderer, pixels);
+    SDL_FreeSurface(pixels);
+    if (!atlas->texture) return false;
+
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void glyph_atlas_free(GlyphAtlas *atlas) {
+    if (atlas->texture) SDL_DestroyTexture(atlas->texture);
+    atlas->texture = NULL;
+}
+
+void glyph_text_size(const GlyphAtlas *atlas, int size, const char *text, int *w, int *h) {
+    int width = 0;
+    for (const char *c = text; *c; c++) {
+        width += atlas->cell[size][glyph_index(*c)].w;
+    }
+    *w = width;
+    *h = atlas->height[size];
+}
+
+void glyph_queue_text(const GlyphAtlas *atlas, SpriteBatch *batch, int size, const char *text, int x, int y, SDL_Color color) {
+    for (const char *c = text; *c; c++) {
+        const SDL_Rect *cell = &atlas->cell[size][glyph_index(*c)];
+        SDL_Rect dst = {x, y, cell->w, cell->h};
+        if (*c != ' ') sprite_batch_add_tinted(batch, cell, &dst, color);
+        x += cell->w;
+    }
+}
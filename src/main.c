@@ -0,0 +1,161 @@
+#define SDL_MAIN_HANDLED
+#include "game.h"
+
+// The command line and the main loop; everything they drive lives in pacman.c.
+
+// Screens that render() leaves alone once drawn, with nothing moving on them.
+static bool is_idle(const AppContext *app) {
+    GameState state = app->game.state;
+    if (state != app->game.prevState || app->needsRedraw) return false;
+    if (state == STATE_ENTER_NAME) return !app->ui.scoreboard.playerName.needsUpdate;
+    return state == STATE_MENU || state == STATE_HELP || state == STATE_RANKING || state == STATE_PAUSED;
+}
+
+static void report_stats(AppContext *app) {
+    RenderStats *stats = &app->stats;
+    uint32_t now = SDL_GetTicks();
+    if (now - stats->lastReport < 1000) return;
+
+    // --threaded: the counters of the sim thread's clock, as of its latest snapshot
+    Scheduler *ticks = app->sim ? &app->simClock : &app->timer.ticks;
+    clock_t cpu = clock();
+    double cpuMs = (double)(cpu - stats->lastCpu) * 1000.0 / CLOCKS_PER_SEC;
+    printf("stats: %u frames/s, %.1f draw calls/frame, %u wakeups/s, cpu %.1f ms/s, ticks %llu dropped %llu, late %.2f ms avg %.2f ms max, screen assets %zu KB\n",
+           stats->frames, stats->frames ? (double)stats->drawCalls / stats->frames : 0.0,
+           stats->wakeups, cpuMs * 1000.0 / (now - stats->lastReport),
+           (unsigned long long)ticks->ticks, (unsigned long long)ticks->dropped,
+           ticks->lateCount ? scheduler_ms(ticks, ticks->lateSum) / ticks->lateCount : 0.0, scheduler_ms(ticks, ticks->lateMax),
+           app->screenAssets.resident >> 10);
+    if (app->soft.surface) {
+        printf("stats: soft %.0f px/frame pushed of %d\n", stats->frames ? (double)app->soft.pushed / stats->frames : 0.0,
+               app->soft.surface->w * app->soft.surface->h);
+        app->soft.pushed = 0;
+    }
+    fflush(stdout);
+    ticks->lateSum = ticks->lateMax = 0;
+    ticks->lateCount = 0;
+    stats->lastReport = now;
+    stats->frames = 0;
+    stats->drawCalls = 0;
+    stats->wakeups = 0;
+    stats->lastCpu = cpu;
+}
+
+int main(int argc, char *argv[]) {
+    AppContext app;
+    World world;
+    static Level level;
+    int32_t worldRows = 0, worldCols = 0;
+    uint32_t worldSeed = (uint32_t)time(NULL);
+    const char *levelPath = NULL;
+    bool stats = false, threaded = false, soft = false;
+    long assetBudgetMb = -1;
+    static SimThread sim;
+
+    // --world ROWSxCOLS (or a single side) plays a generated maze, --seed picks which one
+    // --level FILE plays a board baked by bin/mapc, --stats prints frame counters every second
+    // --threaded steps the game on a thread of its own
+    // --asset-budget MB caps the screen images kept cached once their screen is left
+    // --soft renders on the CPU into the window surface, for machines without a GPU
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--world") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &worldRows, &worldCols) == 1) worldCols = worldRows;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            worldSeed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            levelPath = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else if (strcmp(argv[i], "--threaded") == 0) {
+            threaded = true;
+        } else if (strcmp(argv[i], "--asset-budget") == 0 && i + 1 < argc) {
+            assetBudgetMb = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--soft") == 0) {
+            soft = true;
+        }
+    }
+
+    init_game_application(&app, soft);
+    if (levelPath) {
+        if (!level_load(&level, levelPath)) show_error_and_quit("Level load error", levelPath, &app);
+        app.level = &level;
+        app.game.maze = &level.maze;
+        core_init_level(&app.game, false);
+        reset_motion(&app);
+        app.game.state = STATE_MENU;
+        app.mazeLayer.rebuild = true;
+    }
+    if (assetBudgetMb >= 0) app.screenAssets.budget = (size_t)assetBudgetMb << 20;
+    app.stats.enabled = stats;
+    app.stats.lastReport = SDL_GetTicks();
+    app.stats.lastCpu = clock();
+    if (worldRows > 0) {
+        if (!world_init(&world, worldRows, worldCols, worldSeed)) {
+            show_error_and_quit("Memory error", "Out of memory or null pointer: world chunk table", &app);
+        }
+        app.world = &world;
+        app.game.state = STATE_PLAYING;
+    }
+    // The generated world keeps its own state outside GameLogic and always runs in the main loop
+    if (threaded && app.world) fprintf(stderr, "--threaded is ignored with --world\n");
+    if (threaded && !app.world) {
+        if (!sim_thread_start(&sim, TICK_RATE)) show_error_and_quit("Thread error", SDL_GetError(), &app);
+        app.sim = &sim;
+        scheduler_init(&app.simClock, 1, TICK_RATE);
+    }
+    while (app.isRunning) {
+        // Calculate frame time
+        uint32_t currentTicks = SDL_GetTicks();
+        app.timer.frameMs = currentTicks - app.timer.lastTicks;
+        app.sounds.dotTimer += app.timer.frameMs;
+        app.sounds.moveTimer += app.timer.frameMs;
+        app.timer.lastTicks = currentTicks;
+        
+        app.stats.wakeups++;
+
+        // Event handling. A static screen sleeps in the event wait, which
+        // blocks in the OS since SDL 2.0.16, until input or a window event.
+        if (is_idle(&app)) {
+            if (SDL_WaitEventTimeout(&app.event, IDLE_WAKE_MS)) handle_events(&app);
+            // Nothing was owed while asleep: no burst of ticks or frames after
+            // it, and the sleep is not counted into the next frame's time
+            scheduler_resync(&app.timer.ticks);
+            scheduler_resync(&app.timer.frames);
+            app.timer.lastTicks = SDL_GetTicks();
+        }
+        while (SDL_PollEvent(&app.event)) {
+            handle_events(&app);
+        }
+        
+        // Game state updates. Ticks that fall due outside gameplay are let go,
+        // so pauses and countdowns leave no backlog behind.
+        if (app.sim) {
+            sync_sim(&app);
+        } else {
+            uint32_t ticks = scheduler_due(&app.timer.ticks);
+            if(app.game.state == STATE_PLAYING){
+                update_game(&app, ticks);
+                app.motion.alpha = scheduler_alpha(&app.timer.ticks);
+            }
+        }
+
+        // Rendering
+        render(&app);
+        if (app.stats.enabled) startup_print(&app.startup, "first frame");
+        if (app.stats.enabled) report_stats(&app);
+        
+        // Frame rate control: vsync already blocks in present. Without it frames
+        // are paced to the display, not to the sim: positions in between ticks
+        // are interpolated.
+        if (!app.timer.vsync) {
+            scheduler_wait(&app.timer.frames);
+            scheduler_due(&app.timer.frames);
+        }
+    }
+    
+    if (app.sim) sim_thread_quit(app.sim);
+    if (app.world) world_free(app.world);
+    if (app.stats.enabled) asset_cache_report(&app.screenAssets);
+    quit_game_application(&app);
+    return EXIT_SUCCESS;
+}
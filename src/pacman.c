@@ -1,5 +1,17 @@
-#define SDL_MAIN_HANDLED
-#include "pacman.h"
+#include "game.h"
+
+// spriteClips (in SpriteID order), deathClips and wallClips: places in the
+// packed atlas, generated from tools/atlas.txt by `make atlas`
+#include "atlas.h"
+SDL_COMPILE_TIME_ASSERT(spriteClips, SDL_arraysize(spriteClips) == SPR_NULL + 1);
+
+static const SDL_Color colors[3] ={
+  {255,255,255,255},
+  {0,0,0,255},
+  {150, 150, 150, 255},
+};
+
+static const uint8_t fontSizes[2] = {24,12};
 
 
 // ------------- HELPERS --------------
@@ -37,7 +49,25 @@ static void join_path(const char *base, const char *rel, char *out, size_t out_s
     }
 }
 
-static void show_error_and_quit(const char *title, const char *msg, AppContext *app) {
+// Startup workers write into app until joined, so nothing is freed before that.
+static void track_worker(AppContext *app, SDL_Thread *thread) {
+    for (size_t i = 0; thread && i < SDL_arraysize(app->workers); i++) {
+        if (!app->workers[i]) {
+            app->workers[i] = thread;
+            return;
+        }
+    }
+}
+
+static void wait_worker(AppContext *app, SDL_Thread *thread) {
+    if (!thread) return;
+    for (size_t i = 0; i < SDL_arraysize(app->workers); i++) {
+        if (app->workers[i] == thread) app->workers[i] = NULL;
+    }
+    SDL_WaitThread(thread, NULL);
+}
+
+void show_error_and_quit(const char *title, const char *msg, AppContext *app) {
     if (title == NULL) title = "Error";
     if (msg == NULL) msg = "Unknown error";
 
@@ -48,7 +78,10 @@ static void show_error_and_quit(const char *title, const char *msg, AppContext *
         fprintf(stderr, "%s: %s\n", title, msg);
     }
 
-    if (app) quit_game_application(app);
+    if (app) {
+        for (size_t i = 0; i < SDL_arraysize(app->workers); i++) wait_worker(app, app->workers[i]);
+        quit_game_application(app);
+    }
 
     exit(EXIT_FAILURE);
 }
@@ -92,6 +125,130 @@ static inline void assert_ptr(void *p, const char *what, AppContext *app) {
     show_error_and_quit("Memory error", buf, app);
 }
 
+// ---------- STARTUP JOBS -----------
+// Decoding and audio setup run on worker threads while the main thread brings
+// up the window and renderer; the main thread then joins each job and only
+// does the uploads. Workers never quit the game themselves: they leave an
+// error for the main thread to report after the join. Any error exit first
+// waits for the workers still running (app->workers).
+
+static void asset_path(const char *base, const char *name, char *path, size_t size) {
+    char rel[256];
+    snprintf(rel, sizeof(rel), "assets/%s", name);
+    join_path(base, rel, path, size);
+}
+
+// One image: nothing to decode when the archive has its pixels
+typedef struct {
+  const char *name;       // under assets/
+  SDL_Texture **texture;  // where the upload goes
+  char path[1024];
+  SDL_Surface *surface;
+  SDL_Thread *thread;
+  StartupLog *log;
+} ImageJob;
+
+static int decode_image(void *data) {
+    ImageJob *job = data;
+    int stage = startup_stage_begin(job->log, job->name, "image");
+    job->surface = IMG_Load(job->path);
+    startup_stage_end(job->log, stage);
+    return 0;
+}
+
+static void start_image(AppContext *app, ImageJob *job, const char *base) {
+    asset_path(base, job->name, job->path, sizeof(job->path));
+    job->log = &app->startup;
+    const ArchiveEntry *entry = archive_find(&app->assets, job->name);
+    if (!entry || entry->kind != ARCHIVE_IMAGE) {
+        job->thread = SDL_CreateThread(decode_image, "image", job);
+        track_worker(app, job->thread);
+    }
+}
+
+static void finish_image(AppContext *app, ImageJob *job) {
+    SDL_Texture *texture;
+    if (job->thread) {
+        wait_worker(app, job->thread);
+        texture = job->surface ? SDL_CreateTextureFromSurface(app->renderer, job->surface) : NULL;
+        SDL_FreeSurface(job->surface);
+    } else {
+        texture = archive_texture(&app->assets, app->renderer, job->name);
+    }
+    // The worker could not start, or the archive upload failed: the old way, on this thread
+    if (!texture) texture = IMG_LoadTexture(app->renderer, job->path);
+    assert_texture(texture, job->path, app);
+    *job->texture = texture;
+}
+
+// Every sound, in the order of sounds[]; the device is opened on the main thread first
+#define SOUND_COUNT 5
+typedef struct {
+  const char *names[SOUND_COUNT];
+  Mix_Chunk **sounds[SOUND_COUNT];
+  const char *base;
+  const Archive *assets;
+  StartupLog *log;
+  SDL_Thread *thread;
+  char title[32], error[1100];
+} AudioJob;
+
+static int load_sounds(void *data) {
+    AudioJob *job = data;
+    int stage = startup_stage_begin(job->log, "sounds", "audio");
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        Mix_Chunk *chunk = archive_chunk(job->assets, job->names[i]);
+        if (!chunk) {
+            char path[1024];
+            asset_path(job->base, job->names[i], path, sizeof(path));
+            chunk = Mix_LoadWAV(path);
+            if (!chunk) {
+                snprintf(job->title, sizeof(job->title), "Sound load error");
+                snprintf(job->error, sizeof(job->error), "%s\n%s", path, Mix_GetError());
+                break;
+            }
+        }
+        *job->sounds[i] = chunk;
+    }
+    startup_stage_end(job->log, stage);
+    return job->error[0] ? 1 : 0;
+}
+
+// The font file; SDL_ttf is initialised on the main thread first
+typedef struct {
+  const char *name;
+  int ptsize;
+  const char *base;
+  const Archive *assets;
+  StartupLog *log;
+  TTF_Font *font;
+  SDL_Thread *thread;
+  char title[32], error[1100];
+} FontJob;
+
+static int open_font(void *data) {
+    FontJob *job = data;
+    int stage = startup_stage_begin(job->log, "font", "font");
+    if (!(job->font = archive_font(job->assets, job->name, job->ptsize))) {
+        char path[1024];
+        asset_path(job->base, job->name, path, sizeof(path));
+        job->font = TTF_OpenFont(path, job->ptsize);
+        if (!job->font) {
+            snprintf(job->title, sizeof(job->title), "Font load error");
+            snprintf(job->error, sizeof(job->error), "%s\n%s", path, TTF_GetError());
+        }
+    }
+    startup_stage_end(job->log, stage);
+    return job->error[0] ? 1 : 0;
+}
+
+// Runs the job here if its thread could not be created, then reports its error if any.
+static void join_job(AppContext *app, SDL_Thread *thread, SDL_ThreadFunction run, void *job, const char *title, const char *error) {
+    if (thread) wait_worker(app, thread);
+    else run(job);
+    if (error[0]) show_error_and_quit(title, error, app);
+}
+
 static void safe_destroy_texture(SDL_Texture **tex) {
     if (tex && *tex) {
         SDL_DestroyTexture(*tex);
@@ -108,25 +265,17 @@ static void safe_free_chunk(Mix_Chunk **chunk) {
 
 static void safe_free(void **ptr) {
     if (ptr && *ptr) {
-        free(*ptr);
+        SDL_free(*ptr);
         *ptr = NULL;
     }
 }
 
-static inline void create_text_texture(TextLabel* text, FontSize fontSize , FontColor color, AppContext* app) {
-    safe_destroy_texture(&text->texture);
-
-    TTF_SetFontSize(app->font, fontSizes[fontSize]);    
-    SDL_Surface* surf = TTF_RenderText_Blended(app->font, text->text, colors[color]);
-    if (!surf) return;
-    
-    text->texture = SDL_CreateTextureFromSurface(app->renderer, surf);
-    SDL_FreeSurface(surf);
-    
-    if (text->texture) {
-        text->needsUpdate = false;
-        SDL_QueryTexture(text->texture, NULL,NULL, &text->dst.w,&text->dst.h);
-    }
+// Text changes only restyle and measure the label, glyphs are already in the atlas.
+static inline void layout_text(TextLabel* text, FontSize fontSize , FontColor color, AppContext* app) {
+    text->size = fontSize;
+    text->color = color;
+    glyph_text_size(&app->glyphs, fontSize, text->text, &text->dst.w, &text->dst.h);
+    text->needsUpdate = false;
 }
 
 static inline void center_texture_rect(SpriteImage *img,float scale, int16_t yOffset) {
@@ -150,384 +299,528 @@ static inline SpriteID charToSpriteID(char ch) {
   }
 }
 
-static inline void add_score_to_board(GameLogic *game){
-    add_score(&game->board,game->player.playerName.text,game->player.score);
-    game->player.playerName.text[0] = '\0';
+// Every draw goes through these two so --stats can count them.
+static inline void render_copy(AppContext *app, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst) {
+    SDL_RenderCopy(app->renderer, texture, src, dst);
+    if (app->soft.surface) soft_frame_mark(&app->soft, dst);
+    app->stats.drawCalls++;
+}
+
+static inline void draw_text(AppContext *app, const TextLabel *label) {
+    glyph_queue_text(&app->glyphs, &app->text, label->size, label->text, label->dst.x, label->dst.y, colors[label->color]);
+}
+
+// Text goes last: no label overlaps a sprite drawn after it.
+static inline void present_frame(AppContext *app) {
+    sprite_batch_flush(&app->text);
+    if (app->soft.surface) soft_frame_present(&app->soft, app->renderer);
+    else SDL_RenderPresent(app->renderer);
+    app->stats.frames++;
+}
+
+static inline void add_score_to_board(AppContext *app){
+    add_score(&app->board,app->ui.scoreboard.playerName.text,app->game.player.score);
+    app->ui.scoreboard.playerName.text[0] = '\0';
 } 
 
+// --world runs rank their own score, clamped to the board's 16 bits, then the
+// menu leads back to the classic board.
+static void leave_world(AppContext *app) {
+    static const char worldName[MAX_NAME_LEN + 1] = "WORLD";
+    const char *name = app->ui.scoreboard.playerName.text[0] ? app->ui.scoreboard.playerName.text : worldName;
+    add_score(&app->board, name, (uint16_t)SDL_min(app->world->score, UINT16_MAX));
+    app->ui.scoreboard.playerName.text[0] = '\0';
+
+    world_free(app->world);
+    app->world = NULL;
+    app->ui.overlay.score.needsUpdate = true;
+    app->mazeLayer.rebuild = true;
+}
+
 static inline bool is_valid_name_char(SDL_Keycode key) {
     return (key >= '0' && key <= '9') || (key >= 'a' && key <= 'z') || (key >= 'A' && key <= 'Z');
 }
 
-// -----------------  GAME LOGIC -------------------
-static inline void reset_positions(GameLogic *game) {
-    // Reset pacman
-    game->player.pacman.row = PACMAN_START_ROW;
-    game->player.pacman.col = PACMAN_START_COL;
-    game->player.pacman.dir = DIR_UP;
-    game->player.hunterTime = 0;
-    game->player.ghostCombo = 1;
-    
-    // Reset ghosts
-    const int8_t ghostStartPos[4][2] = {
-        {GHOST_HOME-3, GHOST_HOME},    // Blinky
-        {GHOST_HOME-1, GHOST_HOME},    // Pinky
-        {GHOST_HOME-1, GHOST_HOME-2},  // Inky
-        {GHOST_HOME-1, GHOST_HOME+2}   // Clyde
-    };
-    
-    for (int i = 0; i < 4; i++) {
-        game->ghosts[i].row = ghostStartPos[i][0];
-        game->ghosts[i].col = ghostStartPos[i][1];
-        game->ghosts[i].scared = false;
-        game->ghosts[i].dir = DIR_UP;
-        game->ghosts[i].kind = TYPE_BLINKY+i;
+// Dots change at most once per pacman step, so only those tiles get redrawn.
+static void mark_eaten_tile(AppContext *app, int8_t row, int8_t col) {
+    MazeLayer *layer = &app->mazeLayer;
+    if (layer->patchCount == MAZE_LAYER_PATCHES) {
+        layer->rebuild = true;
+        return;
     }
+    layer->patches[layer->patchCount++] = maze_tile(row, col);
 }
 
-static void init_level(GameLogic *game, bool levelWon) {
-    if (levelWon) {
-        game->player.dotsEaten = 0;
-        if (game->player.lives < 3) game->player.lives++;
-        game->player.rewardCount++;
-    } else {
-        game->player.score = 0;
-        game->player.lives = 3;
-        game->player.rewardCount = 1;
-        game->player.dotsEaten = 0;
+static const GameEntity *motion_entity(const GameLogic *game, int i) {
+    return i == MOTION_PACMAN ? &game->player.pacman : &game->ghosts[i];
+}
+
+// Positions were reset (new level, new life): nothing slides in from the old ones.
+void reset_motion(AppContext *app) {
+    for (int i = 0; i < 5; i++) {
+        const GameEntity *entity = motion_entity(&app->game, i);
+        app->motion.row[i] = entity->row;
+        app->motion.col[i] = entity->col;
     }
-    
-    reset_positions(game);
-    memcpy(game->map, pacman_map, sizeof(pacman_map));
-    game->state = STATE_START_LEVEL;
+    app->motion.alpha = 0.0f;
 }
 
-static bool check_collisions(AppContext *app) {
-    GameLogic*game = &app->game;
-    uint8_t i = 0;
-    for (; i < 4; i++) {
-        if (game->player.pacman.row == game->ghosts[i].row && 
-            game->player.pacman.col == game->ghosts[i].col) {
-            
-            if (game->player.hunterTime > 0 && game->ghosts[i].scared) {
-                // Pacman eats ghost
-                app->ui.overlay.score.needsUpdate = true;
-                game->player.score += game->player.ghostCombo * HUNTER_SCORE_MULTIPLIER;
-                game->player.ghostCombo++;
-                game->ghosts[i].row = GHOST_HOME;
-                game->ghosts[i].col = GHOST_HOME;
-                game->ghosts[i].scared = false;
-                Mix_PlayChannel(-1, app->sounds.eatGhost, 0);
-            }else{
-                if(--game->player.lives == 0){
-                    add_score_to_board(game);
-                    game->state = STATE_GAME_OVER;
-                }else{
-                    game->state =  STATE_LIFE_LOST;
-                }
-                return true;
+// A frame runs fewer ticks than the shortest move period, so each entity moved at most once.
+static void track_motion(AppContext *app, const GameEntity before[5]) {
+    MotionState *motion = &app->motion;
+    for (int i = 0; i < 5; i++) {
+        const GameEntity *entity = motion_entity(&app->game, i);
+        int dr = entity->row - before[i].row, dc = entity->col - before[i].col;
+
+        if (dr == 0 && dc == 0) {
+            // The move timer fired into a wall: stand still until the next move
+            if (entity->moveTimer < before[i].moveTimer) {
+                motion->row[i] = entity->row;
+                motion->col[i] = entity->col;
             }
+        } else if (abs(dr) + abs(dc) == 1) {
+            motion->row[i] = before[i].row;
+            motion->col[i] = before[i].col;
+        } else if (dr == 0 && entity->row == app->game.maze->tunnelRow) {
+            // Through the tunnel: come in from just beyond the board edge
+            motion->row[i] = entity->row;
+            motion->col[i] = entity->col - directionOffsets[entity->dir][1];
+        } else {
+            // Eaten ghost sent home
+            motion->row[i] = entity->row;
+            motion->col[i] = entity->col;
         }
     }
-    return false;
 }
 
-static bool try_move(GameEntity *entity, Direction dir, bool commitMove, GameLogic *game ) {
-    int8_t nextRow = entity->row + directionOffsets[dir][0];
-    int8_t nextCol = entity->col + directionOffsets[dir][1];
-    
-    // Handle tunnel warp
-    if (nextCol < 0) {
-        nextCol = MAP_COLS-1;
-        nextRow = 14;
-    } else if (nextCol >= MAP_COLS-1) {
-        nextCol = 0;
-        nextRow = 14;
-    }
-    
-    if (game->map[nextRow][nextCol] == '#') return false;
-    
-    if (commitMove) {
-        entity->row = nextRow;
-        entity->col = nextCol;
-        entity->dir = dir;
+// Where entity i is drawn this frame, in window pixels relative to the board.
+// Returns how far it is through its current move, 0..1.
+static float motion_position(const AppContext *app, int i, int *x, int *y) {
+    const GameEntity *entity = motion_entity(&app->game, i);
+    float t = (entity->moveTimer + app->motion.alpha * DELTA_TICK) / core_move_period(&app->game, entity);
+    if (t > 1.0f) t = 1.0f;
+
+    int fromRow = app->motion.row[i], fromCol = app->motion.col[i];
+    if (abs(entity->row - fromRow) + abs(entity->col - fromCol) != 1) {
+        fromRow = entity->row;
+        fromCol = entity->col;
     }
-    return true;
+    *x = (int)((fromCol + (entity->col - fromCol) * t) * TILE_WIN_SIZE);
+    *y = (int)((fromRow + (entity->row - fromRow) * t) * TILE_WIN_SIZE);
+    return t;
 }
 
-static void update_ghosts(AppContext *app) {
-    GameLogic *game = &app->game;
-    for(int i = 0; i < 4; i++) {
-        GameEntity* ghost = &app->game.ghosts[i];
-
-        // Calculate speed based on ghost type and game progress
-        ghost->moveTimer += DELTA_TICK_MS;
-        
-        uint16_t timeRequired = ghost->scared ? GHOST_FRIGHTENED_TICKS :
-        ghostBaseTicks[i]-(app->game.player.dotsEaten >> 3);
-
-        if (ghost->moveTimer < timeRequired) continue;
-        ghost->moveTimer = 0;
-
-        if(!ghost->scared || game->player.hunterTime == 0) {
+// -----------------  GAME LOGIC -------------------
+static void handle_core_events(AppContext *app, uint32_t events) {
+    if (events & (CORE_EVENT_EAT_DOT | CORE_EVENT_EAT_ORB)) {
+        if(app->sounds.dotTimer>=300){
+            Mix_PlayChannel(-1, app->sounds.eatDot, 0);
+            app->sounds.dotTimer = 0;
+        }
+    }
+    if (events & CORE_EVENT_EAT_GHOST) Mix_PlayChannel(-1, app->sounds.eatGhost, 0);
+    if (events & CORE_EVENT_SCORE) app->ui.overlay.score.needsUpdate = true;
+    if (events & CORE_EVENT_GAME_OVER) add_score_to_board(app);
+}
 
-            int8_t targetRow = game->player.pacman.row;
-            int8_t targetCol = game->player.pacman.col;
+void update_game(AppContext *app, uint32_t ticks) {
+    if (app->world) {
+        for (; ticks > 0 && app->game.state == STATE_PLAYING; ticks--) {
+            handle_core_events(app, world_step(app->world, app->input));
+            app->input = DIR_COUNT;
+        }
+        return;
+    }
 
-            switch (ghost->kind) {
-                case TYPE_PINKY: // Pinky - targets 4 tiles ahead of Pacman
-                    targetRow += directionOffsets[game->player.pacman.dir][0] << 2;
-                    targetCol += directionOffsets[game->player.pacman.dir][1] << 2;
+    GameEntity before[5];
+    bool newLevel = false;
+    for (int i = 0; i < 5; i++) before[i] = *motion_entity(&app->game, i);
 
-                    // Special case for up direction (original Pacman bug)
-                    if (game->player.pacman.dir == DIR_UP) targetCol -= 4;
-                    break;
+    // Fixed timestep game updates, idle ticks are skipped in bulk.
+    // Stops on every event so each one is handled on its own tick.
+    while (ticks > 0 && app->game.state == STATE_PLAYING) {
+        uint32_t done;
+        uint32_t events = core_advance(&app->game, ticks, app->input, UINT32_MAX, &done);
+        ticks -= done;
 
-                case TYPE_INKY:{ // Inky - uses Blinky's position to calculate target
-                    int8_t pacAheadRow = game->player.pacman.row + (directionOffsets[game->player.pacman.dir][0] << 1);
-                    int8_t pacAheadCol = game->player.pacman.col + (directionOffsets[game->player.pacman.dir][1] << 1);
+        handle_core_events(app, events);
+        app->input = DIR_COUNT;
 
-                    targetRow = pacAheadRow + (pacAheadRow - game->ghosts[0].row); // less blinky position.
-                    targetCol = pacAheadCol + (pacAheadCol - game->ghosts[0].col);
-                    break;
-                }
-                case TYPE_CLYDE: // Clyde - scatters if close to Pacman
-                    if (abs(game->player.pacman.col - ghost->col) + 
-                        abs(game->player.pacman.row - ghost->row) <= 8) {
-                        targetRow = MAP_ROWS - 1;
-                        targetCol = 0;
-                    }
-                    break;
-                default: // Blinky - chases directly
-                    break;
-            }
-
-            Direction bestDir = DIR_COUNT; // Default to current direction
-            uint16_t bestDistance = UINT16_MAX;
-
-            // Try all possible directions (excluding reverse of current direction)
-            for (Direction dir = 0; dir < DIR_COUNT; dir++) {
-                // Ghosts can't reverse direction (unless in scared mode)
-                if (dir == (ghost->dir + 2) % DIR_COUNT) continue;
-                
-                // Check if movement in this direction is possible
-                int8_t nextRow = ghost->row + directionOffsets[dir][0];
-                int8_t nextCol = ghost->col + directionOffsets[dir][1];
-
-                // Skip invalid moves
-                if (nextRow < 0 || nextRow >= MAP_ROWS || 
-                    nextCol < 0 || nextCol >= MAP_COLS || 
-                    game->map[nextRow][nextCol] == '#') {
-                    continue;
-                }
+        // core_advance() stops on each event, so pacman is still on the eaten tile
+        if (events & CORE_EVENT_LEVEL_COMPLETE) app->mazeLayer.rebuild = newLevel = true;
+        else if (events & (CORE_EVENT_EAT_DOT | CORE_EVENT_EAT_ORB)) mark_eaten_tile(app, app->game.player.pacman.row, app->game.player.pacman.col);
+    }
 
-                // Calculate distance to target
-                uint16_t distance = (targetCol - nextCol) * (targetCol - nextCol) + 
-                                   (targetRow - nextRow) * (targetRow - nextRow);
-
-                // Prefer directions that get us closer to target
-                if (distance < bestDistance) {
-                    bestDistance = distance;
-                    bestDir = dir;
-                }else if (distance == bestDistance) {
-                    // Original Pacman ghost movement priorities
-                    bestDir = dir < bestDir ? dir : bestDir; // directions are sorted in a prirority order by defualt.
-                }
-            }
+    if (newLevel) reset_motion(app);
+    else track_motion(app, before);
+}
 
-            if(bestDir == DIR_COUNT) bestDir = (ghost->dir + 2) % DIR_COUNT; // reverse position
-            
-            try_move(ghost, bestDir, true, game);
+// --threaded: what update_game() does after its ticks, worked out from the
+// difference between the copy the main thread holds and a new snapshot.
+static void apply_snapshot(AppContext *app, const SimSnapshot *snapshot) {
+    uint32_t events = CORE_EVENT_NONE;
+    for (int bit = 0; bit < SIM_EVENT_BITS; bit++) {
+        if (snapshot->eventCounts[bit] != app->simEvents[bit]) events |= 1u << bit;
+    }
+    memcpy(app->simEvents, snapshot->eventCounts, sizeof(app->simEvents));
 
-        } else {
-            Direction dir = rand() % DIR_COUNT;
-            uint8_t attempts = 0;    
-            while (attempts < DIR_COUNT) {
-                if (dir != (ghost->dir+2)%DIR_COUNT && try_move(ghost, dir, true, game)) return;
-                dir = (dir + 1) % DIR_COUNT;
-                attempts++;
+    bool newLevel = (events & CORE_EVENT_LEVEL_COMPLETE) != 0;
+    if (newLevel) {
+        app->mazeLayer.rebuild = true;
+    } else {
+        const Maze *maze = app->game.maze;
+        for (int w = 0; w < MAZE_WORDS; w++) {
+            for (uint64_t eaten = app->game.dots[w] & ~snapshot->game.dots[w]; eaten; eaten &= eaten - 1) {
+                uint16_t tile = (uint16_t)(w * 64 + bitboard_popcount64((eaten & -eaten) - 1)); // lowest set bit
+                mark_eaten_tile(app, maze->tileRow[tile], maze->tileCol[tile]);
             }
-            // If no valid move found, continue in current direction
-            try_move(ghost, (ghost->dir+2)%DIR_COUNT, true,game);
         }
     }
+
+    GameEntity before[5];
+    for (int i = 0; i < 5; i++) before[i] = *motion_entity(&app->game, i);
+    GameState prevState = app->game.prevState; // render() keeps that one
+    app->game = snapshot->game;
+    app->game.prevState = prevState;
+    app->simClock = snapshot->clock;
+
+    handle_core_events(app, events);
+    if (newLevel) reset_motion(app);
+    else track_motion(app, before);
 }
 
-void update_game(AppContext *app) {
-    GameLogic *game = &app->game;
-    
-    // Update hunter mode timer
-    if (game->player.hunterTime > 0) {
-        game->player.hunterTime -= DELTA_TICK_MS;
-        if (game->player.hunterTime <= 0) {
-            game->player.hunterTime = 0;
-            for (int i = 0; i < 4; i++) {
-                game->ghosts[i].scared = false;
-            }
-        }
+// --threaded, once per frame: hands the game over when play starts, takes it
+// back when the main thread leaves PLAYING (pause), and otherwise picks up the
+// newest snapshot. The sim thread hands it back by itself on death, game over and win.
+void sync_sim(AppContext *app) {
+    SimThread *sim = app->sim;
+    const SimSnapshot *snapshot;
+
+    if (app->game.state == STATE_PLAYING && !app->simPlaying) {
+        sim_thread_play(sim, &app->game);
+        app->simPlaying = true;
+        app->input = DIR_COUNT;
+    } else if (app->game.state != STATE_PLAYING && app->simPlaying) {
+        GameState state = app->game.state;
+        sim_thread_stop(sim);
+        app->simPlaying = false;
+        if ((snapshot = sim_thread_latest(sim))) apply_snapshot(app, snapshot);
+        // Unless the last ticks ended the session on their own (a death beats a pause)
+        if (app->game.state == STATE_PLAYING) app->game.state = state;
+        return;
     }
-    
-    // Fixed timestep game updates
-    while (app->timer.accumulator >= DELTA_TICK_MS) {
-        app->timer.accumulator -= DELTA_TICK_MS;
-        
-        update_ghosts(app);
-        if (check_collisions(app)) return;
-        
-        // Update pacman
-        game->player.pacman.moveTimer += DELTA_TICK_MS;
-        if(game->player.pacman.moveTimer >= BASE_TICKS ){
-            game->player.pacman.moveTimer = 0;
-            if (!try_move(&game->player.pacman, game->player.pacman.dir, true, game)) {
-                continue; // Pacman couldn't move in desired direction
-            }
-            if (check_collisions(app)) return;
+    if (!app->simPlaying) return;
 
-            char tile = game->map[game->player.pacman.row][game->player.pacman.col];
-            if (tile == '.' || tile == 'o') {
-                if(app->sounds.dotTimer>=300){
-                    Mix_PlayChannel(-1, app->sounds.eatDot, 0);
-                    app->sounds.dotTimer = 0;
-                }
-                game->map[game->player.pacman.row][game->player.pacman.col] = ' ';
-                game->player.dotsEaten++;
-                app->ui.overlay.score.needsUpdate = true;
-                if (tile == 'o') {
-                    game->player.hunterTime = HUNTER_MODE_DURATION_MS;
-                    game->player.score += 50;
-                    game->player.ghostCombo = 1;
-                    for (int i = 0; i < 4; i++) {
-                        game->ghosts[i].scared = true;
-                    }
-                }else game->player.score += 10;
-
-                // Level completion check
-                if (game->player.dotsEaten == TOTAL_DOTS) {
-                    if (game->player.rewardCount == 9) {
-                        game->state = STATE_GAME_COMPLETE;
-                    } else {
-                        init_level(game,true);
-                    }
-                }
-            }       
-        }
+    if (app->input < DIR_COUNT && sim_thread_input(sim, app->input)) app->input = DIR_COUNT;
+    if ((snapshot = sim_thread_latest(sim))) {
+        apply_snapshot(app, snapshot);
+        if (app->game.state != STATE_PLAYING) app->simPlaying = false;
     }
-    
+    app->motion.alpha = scheduler_alpha(&app->simClock);
 }
 
 // --------------  RENDER ---------------
-static void render_enter_name_state(AppContext *app){
+void render_enter_name_state(AppContext *app){
     SDL_Rect inputBox = {(WINDOW_WIDTH>>1)-150,(WINDOW_HEIGHT>>1),300,50};
-    TextLabel *nameLabel = &app->game.player.playerName;
+    TextLabel *nameLabel = &app->ui.scoreboard.playerName;
     nameLabel->dst.x = (WINDOW_WIDTH>>1) - (20 + ((strlen(nameLabel->text)>>1) * 20));
-    create_text_texture(nameLabel, STANDARD,WHITE,app);
+    layout_text(nameLabel, STANDARD,WHITE,app);
 
     SDL_RenderClear(app->renderer);
     SDL_SetRenderDrawColor(app->renderer, 255, 255, 255, 255);
     SDL_RenderDrawRect(app->renderer, &inputBox);
     
-    SDL_RenderCopy(app->renderer, app->ui.menu.title.img, NULL, &app->ui.menu.title.dst);
-    SDL_RenderCopy(app->renderer, nameLabel->texture, NULL, &nameLabel->dst);
-    SDL_RenderCopy(app->renderer, app->ui.scoreboard.hint.texture, NULL, &app->ui.scoreboard.hint.dst);
-    SDL_RenderCopy(app->renderer, app->ui.menu.credit.texture, NULL, &app->ui.menu.credit.dst);        
+    render_copy(app, app->ui.menu.title.img, NULL, &app->ui.menu.title.dst);
+    draw_text(app, nameLabel);
+    draw_text(app, &app->ui.scoreboard.hint);
+    draw_text(app, &app->ui.menu.credit);        
     
     SDL_SetRenderDrawColor(app->renderer, 0,0,0, 255);
-    SDL_RenderPresent(app->renderer);
+    present_frame(app);
     nameLabel->needsUpdate = false;
 }
 
-static void render_playing_state(AppContext *app ,bool present){
-    // Render Map
+// Generated maze: a camera follows pacman and only the chunks in view are drawn,
+// so the frame costs the same whatever the size of the world.
+static void render_world_state(AppContext *app, bool present) {
+    World *world = app->world;
+    WorldView view;
+    world_view(world, MAP_ROWS, MAP_COLS, &view);
+
+    SDL_SetRenderDrawColor(app->renderer, 0, 0, 0, 255);
     SDL_RenderClear(app->renderer);
-    SDL_SetRenderDrawColor(app->renderer, 0,0,0, 255);
 
-    for (int8_t i = 0; i < MAP_ROWS; i++) {
-        for (int8_t j = MAP_COLS-1; j >=0 ; j--) {
-            SDL_Rect tileDst = {
-                j * TILE_WIN_SIZE,
-                i * TILE_WIN_SIZE + MAP_OFFSET_Y,
-                TILE_WIN_SIZE,
-                TILE_WIN_SIZE
-            };
-            
-            SpriteID sprite = charToSpriteID(app->game.map[i][j]);
-            if (sprite > SPR_ORB) {
-                // Special tiles (walls)
-                SDL_Rect wallSrc = {j * TILE_SPR_SIZE + 224,i * TILE_SPR_SIZE,TILE_SPR_SIZE,TILE_SPR_SIZE};
-                SDL_RenderCopy(app->renderer, app->spritesheet, &wallSrc, &tileDst);
-            } else {
-                // Regular tiles (dots, orbs)
-                tileDst.x += TILE_SPR_SIZE;
-                SDL_RenderCopy(app->renderer, app->spritesheet, &spriteClips[sprite], &tileDst);
+    // The view never exceeds the classic board, so its walls fit in one fill
+    SDL_Rect walls[MAP_ROWS * MAP_COLS];
+    int wallCount = 0;
+    for (int32_t cr = view.firstChunkRow; cr <= view.lastChunkRow; cr++) {
+        for (int32_t cc = view.firstChunkCol; cc <= view.lastChunkCol; cc++) {
+            const WorldChunk *chunk = world_chunk(world, cr, cc);
+            if (!chunk) continue;
+
+            int32_t firstRow = SDL_max(view.firstRow, cr * WORLD_CHUNK), lastRow = SDL_min(view.lastRow, cr * WORLD_CHUNK + WORLD_CHUNK - 1);
+            int32_t firstCol = SDL_max(view.firstCol, cc * WORLD_CHUNK), lastCol = SDL_min(view.lastCol, cc * WORLD_CHUNK + WORLD_CHUNK - 1);
+            for (int32_t row = firstRow; row <= lastRow; row++) {
+                for (int32_t col = firstCol; col <= lastCol; col++) {
+                    SDL_Rect tileDst = {
+                        (col - view.firstCol) * TILE_WIN_SIZE,
+                        (row - view.firstRow) * TILE_WIN_SIZE + MAP_OFFSET_Y,
+                        TILE_WIN_SIZE,
+                        TILE_WIN_SIZE
+                    };
+                    uint32_t bit = 1u << (col % WORLD_CHUNK);
+                    if (chunk->walls[row % WORLD_CHUNK] & bit) {
+                        walls[wallCount++] = tileDst;
+                    } else if (chunk->dots[row % WORLD_CHUNK] & bit) {
+                        tileDst.x += TILE_SPR_SIZE;
+                        sprite_batch_add(&app->sprites, &spriteClips[SPR_DOT], &tileDst);
+                    }
+                }
             }
         }
     }
-    
-    // Render ghosts
-    for (int i = 0; i < 4; i++) {
-        GameEntity *ghost = &app->game.ghosts[i];
-        if ( !ghost->scared && app->game.player.hunterTime > 0 && ((int)(SDL_GetTicks() * 0.005)) % 2 == 0) {
-            continue; // Skip rendering during flash
-        }
 
-        SpriteID ghostBase = SPR_GHOST_BLINKY_1;
-        if(app->game.player.hunterTime > 0 && app->game.ghosts[i].scared) ghostBase = app->game.player.hunterTime  <= HUNTER_WARNING_TIME_MS ? SPR_GHOST_SCARY_WHITE_1 : SPR_GHOST_SCARY_BLUE_1;
-        else if (app->game.ghosts[i].kind == TYPE_PINKY) ghostBase = SPR_GHOST_PINKY_1;
-        else if (app->game.ghosts[i].kind == TYPE_INKY) ghostBase = SPR_GHOST_INKY_1;
-        else if (app->game.ghosts[i].kind == TYPE_CLYDE) ghostBase = SPR_GHOST_CLYDE_1;
+    // Dots first: a dot clip spills half a tile right and the walls cover that
+    sprite_batch_flush(&app->sprites);
+    // No wall art exists for generated mazes, walls are plain blue tiles
+    SDL_SetRenderDrawColor(app->renderer, 33, 33, 222, 255);
+    SDL_RenderFillRects(app->renderer, walls, wallCount);
+    app->stats.drawCalls++;
+    SDL_SetRenderDrawColor(app->renderer, 0, 0, 0, 255);
 
-        SDL_Rect ghostDst = {
-            ghost->col * TILE_WIN_SIZE,
-            ghost->row * TILE_WIN_SIZE + MAP_OFFSET_Y,
-            (int)(TILE_WIN_SIZE * 1.25f),
-            (int)(TILE_WIN_SIZE * 1.25f)
-        };
-        SDL_RenderCopy(app->renderer, app->spritesheet, &spriteClips[ghostBase], &ghostDst);
-    }
-    
-    // Render Pacman
-    GameEntity *pacman = &app->game.player.pacman;
     SDL_Rect pacmanDst = {
-        pacman->col * TILE_WIN_SIZE + 6,
-        pacman->row * TILE_WIN_SIZE + MAP_OFFSET_Y,
+        (world->pacCol - view.firstCol) * TILE_WIN_SIZE + 6,
+        (world->pacRow - view.firstRow) * TILE_WIN_SIZE + MAP_OFFSET_Y,
         TILE_WIN_SIZE * 1.25f,
         TILE_WIN_SIZE * 1.25f
     };
-    
-    // Alternate between open and closed mouth for animation
-    SpriteID pacmanSprite = (pacman->dir << 1)  + (pacman->scared ? 1 : 0);
-    pacman->scared = !pacman->scared;
-    
-    SDL_RenderCopy(app->renderer, app->spritesheet, &spriteClips[pacmanSprite], &pacmanDst);
-
-    // Render Game Layout
-    PlayerData *player = &app->game.player;
+    SpriteID pacmanSprite = (world->pacDir << 1) + (world->pacTimer >= BASE_TICKS / 2 ? 1 : 0); // as on the classic board
+    sprite_batch_add(&app->sprites, &spriteClips[pacmanSprite], &pacmanDst);
+    sprite_batch_flush(&app->sprites);
 
     if (app->ui.overlay.score.needsUpdate) {
-        snprintf(app->ui.overlay.score.text, 14, "Score: %05d", player->score);
-        create_text_texture(&app->ui.overlay.score, STANDARD,WHITE,app);
+        snprintf(app->ui.overlay.score.text, 14, "Score: %05u", (unsigned)(world->score % 100000));
+        layout_text(&app->ui.overlay.score, STANDARD,WHITE,app);
     }
+    draw_text(app, &app->ui.overlay.score);
 
-    SDL_RenderCopy(app->renderer, app->ui.overlay.score.texture, NULL, &app->ui.overlay.score.dst);
-    
-    // Render lives
-    SDL_RenderCopy(app->renderer, app->ui.overlay.lives.texture, NULL, &app->ui.overlay.lives.dst);
+    if(present) {
+        present_frame(app);
+        if(app->sounds.moveTimer >= 300){
+            Mix_PlayChannel(-1, app->sounds.move, 0);
+            app->sounds.moveTimer = 0;
+        }
+    }
+}
+
+// Levels address wall art by its place in sprites.png; the atlas only has the
+// cells of the grid tools/atlas.txt cuts out. NULL for art outside it.
+static const SDL_Rect *wall_clip(int sheetX, int sheetY) {
+    int dx = sheetX - wallClipsSheet.x, dy = sheetY - wallClipsSheet.y;
+    if (dx < 0 || dy < 0 || dx % wallClipsSheet.w || dy % wallClipsSheet.h) return NULL;
+    int col = dx / wallClipsSheet.w, row = dy / wallClipsSheet.h;
+    if (row >= (int)SDL_arraysize(wallClips) || col >= (int)SDL_arraysize(wallClips[0])) return NULL;
+    return &wallClips[row][col];
+}
+
+// One board tile as seen from (0, yOffset): wall art, or the dot/orb/empty clip
+// shifted half a tile right, over the left half of the next column.
+static void draw_maze_tile(AppContext *app, int8_t i, int8_t j, int yOffset) {
+    SDL_Rect tileDst = {
+        j * TILE_WIN_SIZE,
+        i * TILE_WIN_SIZE + yOffset,
+        TILE_WIN_SIZE,
+        TILE_WIN_SIZE
+    };
+
+    SpriteID sprite = charToSpriteID(app->game.map[i][j]);
+    if (sprite > SPR_ORB) {
+        // Special tiles (walls)
+        const SDL_Rect *wallSrc = &wallClips[i][j];
+        if (app->level) {
+            const uint16_t *src = app->level->wallSrc[maze_tile(i, j)];
+            wallSrc = wall_clip(src[0], src[1]);
+        }
+        if (wallSrc && app->soft.board) {
+            soft_blit_cell(app->soft.board, app->soft.sheet, wallSrc, &tileDst);
+        } else if (wallSrc) {
+            render_copy(app, app->spritesheet, wallSrc, &tileDst);
+        } else if (app->soft.board) {
+            SDL_FillRect(app->soft.board, &tileDst, SDL_MapRGB(app->soft.board->format, 33, 33, 222));
+        } else {
+            // Art the atlas lacks: a plain wall, as in generated mazes
+            SDL_SetRenderDrawColor(app->renderer, 33, 33, 222, 255);
+            SDL_RenderFillRect(app->renderer, &tileDst);
+            SDL_SetRenderDrawColor(app->renderer, 0, 0, 0, 255);
+            app->stats.drawCalls++;
+        }
+    } else {
+        // Regular tiles (dots, orbs)
+        tileDst.x += TILE_SPR_SIZE;
+        if (app->soft.board) soft_blit_cell(app->soft.board, app->soft.sheet, &spriteClips[sprite], &tileDst);
+        else render_copy(app, app->spritesheet, &spriteClips[sprite], &tileDst);
+    }
+}
+
+// Columns are drawn right to left so each dot clip lands over its right neighbour.
+static void draw_maze_row(AppContext *app, int8_t i, int8_t firstCol, int8_t lastCol, int yOffset) {
+    for (int8_t j = lastCol; j >= firstCol; j--) {
+        draw_maze_tile(app, i, j, yOffset);
+    }
+}
+
+// Brings the cached maze up to date. Must run before the frame is started,
+// it switches the render target. With --soft the maze is the board background
+// surface, drawn with the CPU, and what changed goes to the window next present.
+static void update_maze_layer(AppContext *app) {
+    MazeLayer *layer = &app->mazeLayer;
+    SoftFrame *soft = &app->soft;
+    if ((!layer->texture && !soft->board) || (!layer->rebuild && layer->patchCount == 0)) return;
+
+    if (!soft->board) SDL_SetRenderTarget(app->renderer, layer->texture);
+    if (layer->rebuild) {
+        if (soft->board) {
+            SDL_FillRect(soft->board, NULL, SDL_MapRGB(soft->board->format, 0, 0, 0));
+            soft_frame_dirty(soft, &soft->boardDst);
+        } else {
+            SDL_SetRenderDrawColor(app->renderer, 0,0,0, 255);
+            SDL_RenderClear(app->renderer);
+        }
+        for (int8_t i = 0; i < MAP_ROWS; i++) {
+            draw_maze_row(app, i, 0, MAP_COLS-1, 0);
+        }
+    } else {
+        // An eaten tile only changes its own clip, redraw what overlaps it in the original order.
+        // The clip is cleared first, as a rebuild does: an emptied tile draws unshifted like a
+        // wall, so while the next column still holds a dot nothing else covers the right half.
+        for (uint8_t p = 0; p < layer->patchCount; p++) {
+            int8_t i = app->game.maze->tileRow[layer->patches[p]];
+            int8_t j = app->game.maze->tileCol[layer->patches[p]];
+            SDL_Rect clip = {j * TILE_WIN_SIZE + TILE_SPR_SIZE, i * TILE_WIN_SIZE, TILE_WIN_SIZE, TILE_WIN_SIZE};
+            if (soft->board) {
+                SDL_SetClipRect(soft->board, &clip);
+                SDL_FillRect(soft->board, &clip, SDL_MapRGB(soft->board->format, 0, 0, 0));
+                clip.x += soft->boardDst.x;
+                clip.y += soft->boardDst.y;
+                soft_frame_dirty(soft, &clip);
+            } else {
+                SDL_RenderSetClipRect(app->renderer, &clip);
+                SDL_SetRenderDrawColor(app->renderer, 0,0,0, 255);
+                SDL_RenderFillRect(app->renderer, &clip);
+                app->stats.drawCalls++;
+            }
+            draw_maze_row(app, i, SDL_max(j - 1, 0), SDL_min(j + 1, MAP_COLS-1), 0);
+        }
+        if (soft->board) SDL_SetClipRect(soft->board, NULL);
+        else SDL_RenderSetClipRect(app->renderer, NULL);
+    }
+    if (!soft->board) SDL_SetRenderTarget(app->renderer, NULL);
+
+    layer->rebuild = false;
+    layer->patchCount = 0;
+}
+
+static void draw_maze(AppContext *app) {
+    if (!app->mazeLayer.texture) {
+        for (int8_t i = 0; i < MAP_ROWS; i++) {
+            draw_maze_row(app, i, 0, MAP_COLS-1, MAP_OFFSET_Y);
+        }
+        return;
+    }
+
+    SDL_Rect layerDst = {0, MAP_OFFSET_Y, MAP_COLS * TILE_WIN_SIZE, MAP_ROWS * TILE_WIN_SIZE};
+    render_copy(app, app->mazeLayer.texture, NULL, &layerDst);
+}
+
+// Ghost sprite for this frame, SPR_NULL while the unscared ones flash in hunter mode.
+// Frames follow game time only, so the same state always draws the same picture.
+static SpriteID ghost_sprite(const AppContext *app, const GameEntity *ghost) {
+    int16_t hunterTime = app->game.player.hunterTime;
+    if (!ghost->scared && hunterTime > 0 && (hunterTime / CORE_MS(200)) % 2 == 0) return SPR_NULL;
+
+    if (hunterTime > 0 && ghost->scared) return hunterTime <= HUNTER_WARNING_TIME ? SPR_GHOST_SCARY_WHITE_1 : SPR_GHOST_SCARY_BLUE_1;
+    if (ghost->kind == TYPE_PINKY) return SPR_GHOST_PINKY_1;
+    if (ghost->kind == TYPE_INKY) return SPR_GHOST_INKY_1;
+    if (ghost->kind == TYPE_CLYDE) return SPR_GHOST_CLYDE_1;
+    return SPR_GHOST_BLINKY_1;
+}
+
+static void queue_playing_sprites(AppContext *app) {
+    SpriteBatch *batch = &app->sprites;
+
+    // Ghosts
+    for (int i = 0; i < 4; i++) {
+        GameEntity *ghost = &app->game.ghosts[i];
+        SpriteID ghostBase = ghost_sprite(app, ghost);
+        if (ghostBase == SPR_NULL) continue; // Skip rendering during flash
+
+        SDL_Rect ghostDst = {0, 0, (int)(TILE_WIN_SIZE * 1.25f), (int)(TILE_WIN_SIZE * 1.25f)};
+        motion_position(app, i, &ghostDst.x, &ghostDst.y);
+        ghostDst.y += MAP_OFFSET_Y;
+        sprite_batch_add(batch, &spriteClips[ghostBase], &ghostDst);
+    }
+
+    // Pacman
+    GameEntity *pacman = &app->game.player.pacman;
+    SDL_Rect pacmanDst = {0, 0, TILE_WIN_SIZE * 1.25f, TILE_WIN_SIZE * 1.25f};
+    float step = motion_position(app, MOTION_PACMAN, &pacmanDst.x, &pacmanDst.y);
+    pacmanDst.x += 6;
+    pacmanDst.y += MAP_OFFSET_Y;
+
+    // Mouth closed for the first half of each move, open for the second
+    SpriteID pacmanSprite = (pacman->dir << 1) + (step >= 0.5f ? 1 : 0);
+    if (app->game.state != STATE_LIFE_LOST) sprite_batch_add(batch, &spriteClips[pacmanSprite], &pacmanDst); // the death animation takes its place
+
+    // Lives
+    PlayerData *player = &app->game.player;
     SDL_Rect lifeDst = {app->ui.overlay.lives.dst.x + 98,app->ui.overlay.lives.dst.y - 5,TILE_WIN_SIZE << 1,TILE_WIN_SIZE <<1};
     for (int i = 0; i < player->lives; i++) {
         lifeDst.x += 42;
-        SDL_RenderCopy(app->renderer, app->spritesheet, &spriteClips[SPR_PACMAN_RIGHT_2], &lifeDst);
+        sprite_batch_add(batch, &spriteClips[SPR_PACMAN_RIGHT_2], &lifeDst);
     }
-    
-    // Render rewards
+
+    // Rewards
     SDL_Rect rewardDst = {app->ui.overlay.lives.dst.x + 270,app->ui.overlay.lives.dst.y - 10,TILE_WIN_SIZE * 1.5f,TILE_WIN_SIZE * 1.5f};
     for (int i = 0; i < player->rewardCount; i++) {
         if(i == 5) rewardDst.y += 20;
         rewardDst.x += (i % 5) * 24;
-        SDL_RenderCopy(app->renderer, app->spritesheet, &spriteClips[SPR_REWARD_1 + i], &rewardDst);
+        sprite_batch_add(batch, &spriteClips[SPR_REWARD_1 + i], &rewardDst);
+    }
+}
+
+void render_playing_state(AppContext *app ,bool present){
+    if (app->world) {
+        render_world_state(app, present);
+        return;
+    }
+
+    // Render Map
+    update_maze_layer(app);
+    if (app->soft.board) {
+        soft_frame_restore(&app->soft); // the background comes back only where the last frame drew
+    } else {
+        SDL_RenderClear(app->renderer);
+        SDL_SetRenderDrawColor(app->renderer, 0,0,0, 255);
+        draw_maze(app);
     }
 
+    // Ghosts, pacman, lives and rewards all come from the spritesheet: one submission
+    queue_playing_sprites(app);
+    sprite_batch_flush(&app->sprites);
+
+    // Render Game Layout
+    PlayerData *player = &app->game.player;
+
+    if (app->ui.overlay.score.needsUpdate) {
+        snprintf(app->ui.overlay.score.text, 14, "Score: %05d", player->score);
+        layout_text(&app->ui.overlay.score, STANDARD,WHITE,app);
+    }
+
+    draw_text(app, &app->ui.overlay.score);
+    draw_text(app, &app->ui.overlay.lives);
+
     if(present) {
-        SDL_RenderPresent(app->renderer);
+        present_frame(app);
         if(app->sounds.moveTimer >= 300){
             Mix_PlayChannel(-1, app->sounds.move, 0);
             app->sounds.moveTimer = 0;
@@ -535,154 +828,215 @@ static void render_playing_state(AppContext *app ,bool present){
     }
 }
 
-static void render_life_lost_state(AppContext *app){
-    // Animate pacman death
-    Mix_PlayChannel(-1, app->sounds.death, 0);
-    SDL_Rect pacmanDst = {
-        app->game.player.pacman.col * TILE_WIN_SIZE + 6,
-        app->game.player.pacman.row * TILE_WIN_SIZE + MAP_OFFSET_Y,
-        TILE_WIN_SIZE * 1.25f,
-        TILE_WIN_SIZE * 1.25f
-    };
-    SDL_Rect deathFrame = {504 - TILE_WIN_SIZE, 0, TILE_WIN_SIZE, TILE_WIN_SIZE};    
-    for (int i = 0; i < 11; i++) {
-        deathFrame.x += TILE_WIN_SIZE;
-        SDL_RenderCopy(app->renderer, app->spritesheet, &deathFrame, &pacmanDst);
-        SDL_RenderPresent(app->renderer);
-        SDL_Delay(100);
+// Transitional screens below run one frame per main loop iteration, driven by
+// app->timer.transition, so events keep flowing while they animate.
+
+void render_life_lost_state(AppContext *app, bool entering){
+    Timeline *timeline = &app->timer.transition;
+    if (entering) {
+        Mix_PlayChannel(-1, app->sounds.death, 0);
+        timeline_start(timeline, 11, 100);
+    }
+
+    // Animate pacman death over the board, where the live sprite is left out
+    render_playing_state(app,false);
+    SDL_Rect pacmanDst = {0, 0, TILE_WIN_SIZE * 1.25f, TILE_WIN_SIZE * 1.25f};
+    motion_position(app, MOTION_PACMAN, &pacmanDst.x, &pacmanDst.y);
+    pacmanDst.x += 6;
+    pacmanDst.y += MAP_OFFSET_Y;
+    render_copy(app, app->spritesheet, &deathClips[timeline_step(timeline)], &pacmanDst);
+    present_frame(app);
+
+    if (timeline_advance(timeline, app->timer.frameMs)) {
+        core_resume(&app->game);
+        reset_motion(app);
     }
-    app->game.state = STATE_START_LEVEL;
-    reset_positions(&app->game);
 }
 
-static void render_game_over_state(AppContext *app) {
+void render_game_over_state(AppContext *app, bool entering) {
+    Timeline *timeline = &app->timer.transition;
+    if (entering) timeline_start(timeline, 1, 2000);
+
     SDL_RenderClear(app->renderer);
     SDL_SetRenderDrawColor(app->renderer, 0,0,0, 255);
 
-    SDL_RenderCopy(app->renderer, app->ui.overlay.gameOver.img, NULL, &app->ui.overlay.gameOver.dst);
-    SDL_RenderPresent(app->renderer);
-    
-    SDL_Delay(2000);
-    app->game.state = STATE_MENU;
-    render(app);
+    render_copy(app, app->ui.overlay.gameOver.img, NULL, &app->ui.overlay.gameOver.dst);
+    present_frame(app);
+
+    if (timeline_advance(timeline, app->timer.frameMs)) app->game.state = STATE_MENU;
 }
 
-static void render_start_level_state(AppContext *app) {
+void render_start_level_state(AppContext *app, bool entering) {
     // Countdown animation
+    Timeline *timeline = &app->timer.transition;
     TextLabel *readyLabel = &app->ui.overlay.ready;
-    Mix_PlayChannel(-1,app->sounds.start, 0);
-    for (int i = 3; i > 0; i--) {
-        render_playing_state(app,false); // render game to have a background.
-        snprintf(readyLabel->text, 10, "!Ready %1d", i);
-        create_text_texture(readyLabel, STANDARD,WHITE,app);
-        
-        SDL_RenderCopy(app->renderer, readyLabel->texture, NULL, &readyLabel->dst);
-        SDL_RenderPresent(app->renderer);
+    if (entering) {
+        Mix_PlayChannel(-1,app->sounds.start, 0);
+        timeline_start(timeline, 3, 1000);
+    }
 
-        SDL_Delay(1000);
+    render_playing_state(app,false); // render game to have a background.
+    snprintf(readyLabel->text, 10, "!Ready %1d", 3 - timeline_step(timeline));
+    layout_text(readyLabel, STANDARD,WHITE,app);
+    draw_text(app, readyLabel);
+    present_frame(app);
+
+    if (timeline_advance(timeline, app->timer.frameMs)) {
+        core_resume(&app->game);
+        reset_motion(app);
     }
-    app->timer.accumulator = -3000;
-    app->game.state = STATE_PLAYING;
 }
 
-static void render_menu_state(AppContext *app) {
+void render_menu_state(AppContext *app) {
     // Draw title and menu options
     SDL_RenderClear(app->renderer);
     SDL_SetRenderDrawColor(app->renderer, 0, 0, 0, 255);
 
-    SDL_RenderCopy(app->renderer, app->ui.menu.title.img, NULL, &app->ui.menu.title.dst);
-    SDL_RenderCopy(app->renderer, app->ui.menu.play.texture, NULL, &app->ui.menu.play.dst);
-    SDL_RenderCopy(app->renderer, app->ui.menu.help.texture, NULL, &app->ui.menu.help.dst);
-    SDL_RenderCopy(app->renderer, app->ui.menu.exit.texture, NULL, &app->ui.menu.exit.dst);
-    SDL_RenderCopy(app->renderer, app->ui.menu.rank.texture, NULL, &app->ui.menu.rank.dst);
-    SDL_RenderCopy(app->renderer, app->ui.menu.credit.texture, NULL, &app->ui.menu.credit.dst);
+    render_copy(app, app->ui.menu.title.img, NULL, &app->ui.menu.title.dst);
+    draw_text(app, &app->ui.menu.play);
+    draw_text(app, &app->ui.menu.help);
+    draw_text(app, &app->ui.menu.exit);
+    draw_text(app, &app->ui.menu.rank);
+    draw_text(app, &app->ui.menu.credit);
     
     // Draw ghost previews
     SDL_Rect ghostDst = {(WINDOW_WIDTH>>1) - 185, 450, TILE_WIN_SIZE * 4, TILE_WIN_SIZE * 4};
     for (int j = 0; j < 4; j++) {
-        SDL_RenderCopy(app->renderer, app->spritesheet, 
+        render_copy(app, app->spritesheet, 
             &spriteClips[SPR_GHOST_BLINKY_1 + (j << 1)], &ghostDst);
         ghostDst.x += 100;
     }
-    SDL_RenderPresent(app->renderer);
+    present_frame(app);
 }
 
-static void render_help_state(AppContext *app) {
+void render_help_state(AppContext *app) {
     // Get help image dimensions and scale it
     SDL_RenderClear(app->renderer);
     SDL_SetRenderDrawColor(app->renderer, 0, 0, 0, 255);
 
     SDL_Rect helpDst = {-20, 20, app->ui.help.textW >>1,app->ui.help.textW >> 1};
     
-    SDL_RenderCopy(app->renderer, app->ui.help.helpImg, NULL, &helpDst);
-    SDL_RenderCopy(app->renderer, app->ui.menu.credit.texture, NULL, &app->ui.menu.credit.dst);
-    SDL_RenderPresent(app->renderer);
+    render_copy(app, app->ui.help.helpImg, NULL, &helpDst);
+    draw_text(app, &app->ui.menu.credit);
+    present_frame(app);
 }
 
-static void render_paused_state(AppContext *app) {
-    SDL_RenderCopy(app->renderer, app->ui.overlay.pause.img, NULL, &app->ui.overlay.pause.dst);
-    SDL_RenderPresent(app->renderer);
+void render_paused_state(AppContext *app) {
+    render_playing_state(app,false); // the frozen board, so a redraw after an expose is whole
+    render_copy(app, app->ui.overlay.pause.img, NULL, &app->ui.overlay.pause.dst);
+    present_frame(app);
 }
 
-static void render_game_complete_state(AppContext *app) {
-    Mix_PlayChannel(-1, app->sounds.win, 0);
-    SDL_RenderCopy(app->renderer, app->ui.overlay.gameWin.img, NULL, &app->ui.overlay.gameWin.dst);
-    SDL_RenderPresent(app->renderer);
-    SDL_Delay(2000);
-    app->game.state = STATE_MENU;
+void render_game_complete_state(AppContext *app, bool entering) {
+    Timeline *timeline = &app->timer.transition;
+    if (entering) {
+        Mix_PlayMusic(asset_cache_music(&app->screenAssets, SCREEN_WIN_SOUND), 0);
+        timeline_start(timeline, 1, 2000);
+    }
+
+    render_playing_state(app,false);
+    render_copy(app, app->ui.overlay.gameWin.img, NULL, &app->ui.overlay.gameWin.dst);
+    present_frame(app);
+
+    if (timeline_advance(timeline, app->timer.frameMs)) app->game.state = STATE_MENU;
 }
 
-static void render_ranking_state(AppContext *app) {
+void render_ranking_state(AppContext *app) {
     SDL_RenderClear(app->renderer);
     SDL_SetRenderDrawColor(app->renderer, 0, 0, 0, 255);
 
-    SDL_RenderCopy(app->renderer, app->ui.scoreboard.rankingImg.img, NULL, &app->ui.scoreboard.rankingImg.dst);
+    render_copy(app, app->ui.scoreboard.rankingImg.img, NULL, &app->ui.scoreboard.rankingImg.dst);
     
     // Render scoreboard entries
-    for (int i = 0; i < app->game.board.count; i++) {
+    for (int i = 0; i < app->board.count; i++) {
         // Render name
         app->ui.scoreboard.names.dst.y = app->ui.scoreboard.rankingImg.dst.y + (int)(app->ui.scoreboard.rankingImg.dst.h * (0.225f + 0.063f * i));
-        strncpy(app->ui.scoreboard.names.text, app->game.board.scores[i].name, MAX_NAME_LEN);
+        strncpy(app->ui.scoreboard.names.text, app->board.scores[i].name, MAX_NAME_LEN);
         app->ui.scoreboard.names.text[MAX_NAME_LEN] = '\0';
-        create_text_texture(&app->ui.scoreboard.names, SMALL,WHITE,app);
+        layout_text(&app->ui.scoreboard.names, SMALL,WHITE,app);
         
         // Render score
         app->ui.scoreboard.scores.dst.y = app->ui.scoreboard.names.dst.y;
-        snprintf(app->ui.scoreboard.scores.text, 6, "%5d", app->game.board.scores[i].score);
-        create_text_texture(&app->ui.scoreboard.scores, SMALL,WHITE,app);
+        snprintf(app->ui.scoreboard.scores.text, 6, "%5d", app->board.scores[i].score);
+        layout_text(&app->ui.scoreboard.scores, SMALL,WHITE,app);
         
         // Position and render both
-        SDL_RenderCopy(app->renderer, app->ui.scoreboard.names.texture, NULL, &app->ui.scoreboard.names.dst);
-        SDL_RenderCopy(app->renderer, app->ui.scoreboard.scores.texture, NULL, &app->ui.scoreboard.scores.dst);
+        draw_text(app, &app->ui.scoreboard.names);
+        draw_text(app, &app->ui.scoreboard.scores);
     }
     
-    SDL_RenderCopy(app->renderer, app->ui.menu.credit.texture, NULL, &app->ui.menu.credit.dst);
-    SDL_RenderPresent(app->renderer);
+    draw_text(app, &app->ui.menu.credit);
+    present_frame(app);
+}
+
+// Which ScreenAsset bits each state shows
+uint8_t screen_assets(GameState state) {
+    switch (state) {
+        case STATE_HELP: return 1 << SCREEN_HELP;
+        case STATE_RANKING: return 1 << SCREEN_RANKING;
+        case STATE_PAUSED: return 1 << SCREEN_PAUSE;
+        case STATE_GAME_OVER: return 1 << SCREEN_GAME_OVER;
+        case STATE_GAME_COMPLETE: return (1 << SCREEN_GAME_WIN) | (1 << SCREEN_WIN_SOUND);
+        default: return 0;
+    }
+}
+
+// Released assets may be evicted at any later acquire, so their pointers are dropped
+static SDL_Texture *held_texture(AppContext *app, ScreenAsset asset) {
+    return app->heldAssets & (1 << asset) ? asset_cache_texture(&app->screenAssets, asset) : NULL;
+}
+
+void hold_screen_assets(AppContext *app, uint8_t want) {
+    if (want == app->heldAssets) return;
+
+    // Release first, so the cache can make room with what the old screen let go
+    for (uint8_t i = 0; i < SCREEN_ASSET_COUNT; i++) {
+        if ((app->heldAssets & ~want) & (1 << i)) asset_cache_release(&app->screenAssets, i);
+    }
+    for (uint8_t i = 0; i < SCREEN_ASSET_COUNT; i++) {
+        if ((want & ~app->heldAssets) & (1 << i) && !asset_cache_acquire(&app->screenAssets, i)) {
+            show_error_and_quit("Asset load error", app->screenAssets.assets[i].name, app);
+        }
+    }
+    app->heldAssets = want;
+
+    app->ui.help.helpImg = held_texture(app, SCREEN_HELP);
+    app->ui.scoreboard.rankingImg.img = held_texture(app, SCREEN_RANKING);
+    app->ui.overlay.pause.img = held_texture(app, SCREEN_PAUSE);
+    app->ui.overlay.gameOver.img = held_texture(app, SCREEN_GAME_OVER);
+    app->ui.overlay.gameWin.img = held_texture(app, SCREEN_GAME_WIN);
+    if (app->ui.help.helpImg) SDL_QueryTexture(app->ui.help.helpImg, NULL, NULL, &app->ui.help.textW, &app->ui.help.textH);
+    if (app->ui.scoreboard.rankingImg.img) center_texture_rect(&app->ui.scoreboard.rankingImg, 0.4f, 0);
+    if (app->ui.overlay.pause.img) center_texture_rect(&app->ui.overlay.pause, 0.4f, 0);
+    if (app->ui.overlay.gameOver.img) center_texture_rect(&app->ui.overlay.gameOver, 0.5f, 0);
+    if (app->ui.overlay.gameWin.img) center_texture_rect(&app->ui.overlay.gameWin, 0.4f, 0);
 }
 
 void render(AppContext *app) {
     GameState currentState = app->game.state;
     GameState prevState = app->game.prevState;
+    bool entering = currentState != prevState;
+    hold_screen_assets(app, screen_assets(currentState));
     
     switch (currentState) {
         case STATE_ENTER_NAME:
-            if(app->game.player.playerName.needsUpdate) render_enter_name_state(app);
+            if(app->ui.scoreboard.playerName.needsUpdate) render_enter_name_state(app);
             break;
             
         case STATE_LIFE_LOST:
-            render_life_lost_state(app);
+            render_life_lost_state(app, entering);
             break;
             
         case STATE_GAME_OVER:
-            render_game_over_state(app);
+            render_game_over_state(app, entering);
             break;
             
         case STATE_START_LEVEL:
-            render_start_level_state(app);
+            render_start_level_state(app, entering);
             break;
             
         case STATE_MENU:
-            if (prevState != STATE_MENU) {
+            if (prevState != STATE_MENU || app->needsRedraw) {
                 render_menu_state(app);
             }
             break;
@@ -692,67 +1046,82 @@ void render(AppContext *app) {
             break;
             
         case STATE_HELP:
-            if (prevState != STATE_HELP) {
+            if (prevState != STATE_HELP || app->needsRedraw) {
                 render_help_state(app);
             }
             break;
             
         case STATE_PAUSED:
-            if (prevState != STATE_PAUSED) {
+            if (prevState != STATE_PAUSED || app->needsRedraw) {
                 render_paused_state(app);
             }
             break;
             
         case STATE_GAME_COMPLETE:
-            render_game_complete_state(app);
+            render_game_complete_state(app, entering);
             break;
             
         case STATE_RANKING:
-            if (prevState != STATE_RANKING) {
+            if (prevState != STATE_RANKING || app->needsRedraw) {
                 render_ranking_state(app);
             }
             break;
     }
 
     app->game.prevState = currentState;
+    app->needsRedraw = false;
 }
 
 // ---------------- INIT AND QUIT ----------------
-void init_game_application(AppContext *app) {
+// The software renderer only tells how much it drew; the backend needs where.
+static void mark_submission(void *context, const SDL_Rect *dst, int count) {
+    for (int i = 0; i < count; i++) soft_frame_mark(context, &dst[i]);
+}
+
+// Atlas pixels for the board background: from the archive's mapping, else decoded.
+static void load_soft_sheet(AppContext *app, const char *base) {
+    char path[1024];
+    SDL_Surface *pixels = archive_surface(&app->assets, ATLAS_IMAGE);
+    if (!pixels) {
+        join_path(base, "assets/" ATLAS_IMAGE, path, sizeof(path));
+        pixels = IMG_Load(path);
+    }
+    assertGame(pixels && soft_frame_sheet(&app->soft, pixels), "Failed to load the atlas for --soft", app);
+    SDL_FreeSurface(pixels);
+}
+
+void init_game_application(AppContext *app, bool soft) {
     memset(app, 0, sizeof(AppContext));
+    startup_begin(&app->startup);
 
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_AUDIO) != 0) {
+    // Subsystems come up here; sounds and the font only decode on their threads below
+    int stage = startup_stage_begin(&app->startup, "SDL init", "main");
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0) {
         fprintf(stderr, "SDL_Init failed: %s\n", SDL_GetError());
         exit(EXIT_FAILURE);
     }
-    if (TTF_Init() != 0) {
-        fprintf(stderr, "TTF_Init failed: %s\n", TTF_GetError());
-        SDL_Quit();
-        exit(EXIT_FAILURE);
-    }
     if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) == 0) {
         fprintf(stderr, "IMG_Init failed: %s\n", IMG_GetError());
-        TTF_Quit();
         SDL_Quit();
         exit(EXIT_FAILURE);
     }
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
-        fprintf(stderr, "Mix_OpenAudio failed: %s\n", Mix_GetError());
+    if (TTF_Init() != 0) {
+        fprintf(stderr, "TTF_Init failed: %s\n", TTF_GetError());
         IMG_Quit();
-        TTF_Quit();
         SDL_Quit();
         exit(EXIT_FAILURE);
     }
-
-    app->window = SDL_CreateWindow("Pacman Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                                   WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
-    assertGame(app->window != NULL, "Failed to create SDL window", app);
-
-    app->renderer = SDL_CreateRenderer(app->window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    assertGame(app->renderer != NULL, "Failed to create SDL renderer", app);
-
-    SDL_RenderSetLogicalSize(app->renderer, WINDOW_WIDTH, WINDOW_HEIGHT);
-    SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+    startup_stage_end(&app->startup, stage);
+
+    // SDL and SDL_mixer keep global state, so the device opens here and the worker only decodes
+    stage = startup_stage_begin(&app->startup, "audio device", "main");
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0 ||
+        Mix_OpenAudio(ARCHIVE_AUDIO_FREQ, ARCHIVE_AUDIO_FORMAT, ARCHIVE_AUDIO_CHANNELS, 2048) != 0) {
+        char msg[512];
+        snprintf(msg, sizeof(msg), "Mix_OpenAudio failed: %s", Mix_GetError());
+        show_error_and_quit("Audio error", msg, app);
+    }
+    startup_stage_end(&app->startup, stage);
 
     char *base = SDL_GetBasePath();
     char pathbuf[1024] = {0};
@@ -765,171 +1134,198 @@ void init_game_application(AppContext *app) {
         for(uint16_t i = len-2 ; i>0 && base[i] != PATH_SEP[0] ; i--) base[i] = '\0'; 
     }
 
-    /* FONT */
-    join_path(base, "assets/font/PressStart2P-Regular.ttf", pathbuf, sizeof(pathbuf));
+    /* ARCHIVE: built by `make archive`, the loose files are used without it */
+    stage = startup_stage_begin(&app->startup, "map archive", "main");
+    join_path(base, "assets.pak", pathbuf, sizeof(pathbuf));
+    if (archive_open(&app->assets, pathbuf)) printf("Assets : %s\n", pathbuf);
+    startup_stage_end(&app->startup, stage);
+
+    /* WORKERS: sounds, font and the images the archive lacks decode while the window comes up */
+    AudioJob audio = {
+        .names = {"sounds/pacman_death.wav", "sounds/eat_dot.wav", "sounds/eat_ghost.wav",
+                  "sounds/pacman_move.wav", "sounds/start_level.wav"},
+        .sounds = {&app->sounds.death, &app->sounds.eatDot, &app->sounds.eatGhost,
+                   &app->sounds.move, &app->sounds.start},
+        .base = base, .assets = &app->assets, .log = &app->startup
+    };
+    audio.thread = SDL_CreateThread(load_sounds, "audio", &audio);
+    track_worker(app, audio.thread);
+
     printf("Font base : %s\n",base);
-    app->font = TTF_OpenFont(pathbuf, fontSizes[STANDARD]);
-    assert_font(app->font, pathbuf, app);
+    FontJob font = {.name = "font/PressStart2P-Regular.ttf", .ptsize = fontSizes[STANDARD],
+                    .base = base, .assets = &app->assets, .log = &app->startup};
+    font.thread = SDL_CreateThread(open_font, "font", &font);
+    track_worker(app, font.thread);
+
+    ImageJob images[] = {
+        {.name = "images/menu_title.png", .texture = &app->ui.menu.title.img},
+        {.name = ATLAS_IMAGE, .texture = &app->spritesheet}
+    };
+    for (size_t i = 0; i < SDL_arraysize(images); i++) start_image(app, &images[i], base);
+
+    stage = startup_stage_begin(&app->startup, "window and renderer", "main");
+    app->window = SDL_CreateWindow("Pacman Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                   WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
+    assertGame(app->window != NULL, "Failed to create SDL window", app);
+
+    if (soft) {
+        // No GPU: SDL draws into the window surface and the backend decides what reaches the screen
+        assertGame(soft_frame_init(&app->soft, app->window), "Failed to get the window surface", app);
+        app->renderer = SDL_CreateSoftwareRenderer(app->soft.surface);
+    } else {
+        // Only read when the renderer is created
+        SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+        app->renderer = SDL_CreateRenderer(app->window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    }
+    assertGame(app->renderer != NULL, "Failed to create SDL renderer", app);
+
+    SDL_RenderSetLogicalSize(app->renderer, WINDOW_WIDTH, WINDOW_HEIGHT);
+
+    // Some drivers ignore the vsync request, frames are paced by hand then. The software
+    // renderers report PRESENTVSYNC too, but their present returns at once.
+    SDL_RendererInfo rendererInfo;
+    app->timer.vsync = SDL_GetRendererInfo(app->renderer, &rendererInfo) == 0 &&
+                       (rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC) &&
+                       !(rendererInfo.flags & SDL_RENDERER_SOFTWARE);
+
+    // Without render targets the maze is simply drawn tile by tile every frame
+    if (soft) {
+        assertGame(soft_frame_board(&app->soft, &(SDL_Rect){0, MAP_OFFSET_Y, MAP_COLS * TILE_WIN_SIZE, MAP_ROWS * TILE_WIN_SIZE}),
+                   "Failed to create the board background", app);
+    } else if (SDL_RenderTargetSupported(app->renderer)) {
+        app->mazeLayer.texture = SDL_CreateTexture(app->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                                   MAP_COLS * TILE_WIN_SIZE, MAP_ROWS * TILE_WIN_SIZE);
+    }
+    app->mazeLayer.rebuild = true;
+    startup_stage_end(&app->startup, stage);
 
-    app->ui.menu.play.text = strdup("PLAY (S)");
+    app->ui.menu.play.text = SDL_strdup("PLAY (S)");
     app->ui.menu.play.dst = (SDL_Rect){120, 200, 0, 0};
 
-    app->ui.menu.help.text = strdup("HELP (H)");
+    app->ui.menu.help.text = SDL_strdup("HELP (H)");
     app->ui.menu.help.dst = (SDL_Rect){120, 250, 0, 0};
 
-    app->ui.menu.rank.text = strdup("RANK (R)");
+    app->ui.menu.rank.text = SDL_strdup("RANK (R)");
     app->ui.menu.rank.dst = (SDL_Rect){120, 300, 0, 0};
 
-    app->ui.menu.exit.text = strdup("EXIT (ESC)");
+    app->ui.menu.exit.text = SDL_strdup("EXIT (ESC)");
     app->ui.menu.exit.dst = (SDL_Rect){100, 350, 0, 0};
 
-    app->ui.menu.credit.text = strdup("@ Made by Facundo Gauna");
+    app->ui.menu.credit.text = SDL_strdup("@ Made by Facundo Gauna");
     app->ui.menu.credit.dst = (SDL_Rect){10, 575, 0, 0};
 
-    app->ui.overlay.score.text = strdup("Score: 00000");
+    app->ui.overlay.score.text = SDL_strdup("Score: 00000");
     app->ui.overlay.score.dst = (SDL_Rect){30, (int)(MAP_OFFSET_Y * 0.3f), 0, 0};
 
-    app->ui.overlay.lives.text = strdup("Lives: ");
+    app->ui.overlay.lives.text = SDL_strdup("Lives: ");
     app->ui.overlay.lives.dst = (SDL_Rect){30, MAP_ROWS * TILE_WIN_SIZE + MAP_OFFSET_Y + 12, 0, 0};
 
-    app->ui.overlay.ready.text = strdup("!Ready 3");
+    app->ui.overlay.ready.text = SDL_strdup("!Ready 3");
     app->ui.overlay.ready.dst = (SDL_Rect){(int)(MAP_COLS * 4.75), 17 * TILE_WIN_SIZE + MAP_OFFSET_Y, 0, 0};
 
-    app->ui.scoreboard.hint.text = strdup("__Enter a name__");
+    app->ui.scoreboard.hint.text = SDL_strdup("__Enter a name__");
     app->ui.scoreboard.hint.dst = (SDL_Rect){(WINDOW_WIDTH >> 1) - 190, (WINDOW_HEIGHT >> 1) - 30, 0, 0};
 
-    app->ui.scoreboard.names.text = malloc(MAX_NAME_LEN+1);
+    app->ui.scoreboard.names.text = SDL_malloc(MAX_NAME_LEN+1);
     assert_ptr(app->ui.scoreboard.names.text, "scoreboard.names.text alloc", app);
     app->ui.scoreboard.names.dst = (SDL_Rect){(WINDOW_WIDTH >> 1) - 75, (WINDOW_HEIGHT >> 1), 0, 0};
 
-    app->ui.scoreboard.scores.text = malloc(6);
+    app->ui.scoreboard.scores.text = SDL_malloc(6);
     assert_ptr(app->ui.scoreboard.scores.text, "scoreboard.scores.text alloc", app);
     app->ui.scoreboard.scores.dst = (SDL_Rect){(WINDOW_WIDTH >> 1) + 50, (WINDOW_HEIGHT >> 1), 0, 0};
 
-    app->game.player.playerName.text = malloc(MAX_NAME_LEN+1);
-    assert_ptr(app->game.player.playerName.text, "playerName.text alloc", app);
-    app->game.player.playerName.dst = (SDL_Rect) {0,(WINDOW_HEIGHT>>1)+10,0,0};
-    app->game.player.playerName.text[0] = '\0';
-
-    /* -- IMAGE TEXTURES */
-    join_path(base, "assets/images/help.png", pathbuf, sizeof(pathbuf));
-    app->ui.help.helpImg = IMG_LoadTexture(app->renderer, pathbuf);
-    assert_texture(app->ui.help.helpImg, pathbuf, app);
-
-    join_path(base, "assets/images/menu_title.png", pathbuf, sizeof(pathbuf));
-    app->ui.menu.title.img = IMG_LoadTexture(app->renderer, pathbuf);
-    assert_texture(app->ui.menu.title.img, pathbuf, app);
-
-    join_path(base, "assets/images/game_over.png", pathbuf, sizeof(pathbuf));
-    app->ui.overlay.gameOver.img = IMG_LoadTexture(app->renderer, pathbuf);
-    assert_texture(app->ui.overlay.gameOver.img, pathbuf, app);
-
-    join_path(base, "assets/images/pause.png", pathbuf, sizeof(pathbuf));
-    app->ui.overlay.pause.img = IMG_LoadTexture(app->renderer, pathbuf);
-    assert_texture(app->ui.overlay.pause.img, pathbuf, app);
+    app->ui.scoreboard.playerName.text = SDL_malloc(MAX_NAME_LEN+1);
+    assert_ptr(app->ui.scoreboard.playerName.text, "playerName.text alloc", app);
+    app->ui.scoreboard.playerName.dst = (SDL_Rect) {0,(WINDOW_HEIGHT>>1)+10,0,0};
+    app->ui.scoreboard.playerName.text[0] = '\0';
 
-    join_path(base, "assets/images/game_complete.png", pathbuf, sizeof(pathbuf));
-    app->ui.overlay.gameWin.img = IMG_LoadTexture(app->renderer, pathbuf);
-    assert_texture(app->ui.overlay.gameWin.img, pathbuf, app);
-
-    join_path(base, "assets/images/scoreboard.png", pathbuf, sizeof(pathbuf));
-    app->ui.scoreboard.rankingImg.img = IMG_LoadTexture(app->renderer, pathbuf);
-    assert_texture(app->ui.scoreboard.rankingImg.img, pathbuf, app);
-
-    join_path(base, "assets/images/sprites.png", pathbuf, sizeof(pathbuf));
-    app->spritesheet = IMG_LoadTexture(app->renderer, pathbuf);
-    assert_texture(app->spritesheet, pathbuf, app);
+    /* FONT */
+    join_job(app, font.thread, open_font, &font, font.title, font.error);
+    app->font = font.font;
+    stage = startup_stage_begin(&app->startup, "glyph atlas", "main");
+    assertGame(glyph_atlas_build(&app->glyphs, app->renderer, app->font, fontSizes, SDL_arraysize(fontSizes)),
+               "Failed to build the glyph atlas", app);
+    sprite_batch_init(&app->text, app->renderer, app->glyphs.texture, &app->stats.drawCalls);
+    if (soft) {
+        app->text.onSubmit = mark_submission;
+        app->text.onSubmitContext = &app->soft;
+    }
+    startup_stage_end(&app->startup, stage);
+
+    /* -- IMAGE TEXTURES: uploads stay on the render thread */
+    stage = startup_stage_begin(&app->startup, "upload images", "main");
+    for (size_t i = 0; i < SDL_arraysize(images); i++) finish_image(app, &images[i]);
+    sprite_batch_init(&app->sprites, app->renderer, app->spritesheet, &app->stats.drawCalls);
+    if (soft) {
+        app->sprites.onSubmit = mark_submission;
+        app->sprites.onSubmitContext = &app->soft;
+        load_soft_sheet(app, base);
+    }
+    startup_stage_end(&app->startup, stage);
 
     /* -- SOUNDS */
-    join_path(base, "assets/sounds/pacman_death.wav", pathbuf, sizeof(pathbuf));
-    app->sounds.death = Mix_LoadWAV(pathbuf);
-    assert_chunk(app->sounds.death, pathbuf, app);
-
-    join_path(base, "assets/sounds/eat_dot.wav", pathbuf, sizeof(pathbuf));
-    app->sounds.eatDot = Mix_LoadWAV(pathbuf);
-    assert_chunk(app->sounds.eatDot, pathbuf, app);
-
-    join_path(base, "assets/sounds/eat_ghost.wav", pathbuf, sizeof(pathbuf));
-    app->sounds.eatGhost = Mix_LoadWAV(pathbuf);
-    assert_chunk(app->sounds.eatGhost, pathbuf, app);
-
-    join_path(base, "assets/sounds/pacman_move.wav", pathbuf, sizeof(pathbuf));
-    app->sounds.move = Mix_LoadWAV(pathbuf);
-    assert_chunk(app->sounds.move, pathbuf, app);
-
-    join_path(base, "assets/sounds/start_level.wav", pathbuf, sizeof(pathbuf));
-    app->sounds.start = Mix_LoadWAV(pathbuf);
-    assert_chunk(app->sounds.start, pathbuf, app);
-
-    join_path(base, "assets/sounds/win.wav", pathbuf, sizeof(pathbuf));
-    app->sounds.win = Mix_LoadWAV(pathbuf);
-    assert_chunk(app->sounds.win, pathbuf, app);
+    join_job(app, audio.thread, load_sounds, &audio, audio.title, audio.error);
+
+    /* -- SCREEN ASSETS: loaded on entry into the screens that show them, in ScreenAsset order */
+    join_path(base, "assets/", pathbuf, sizeof(pathbuf));
+    asset_cache_init(&app->screenAssets, app->renderer, &app->assets, pathbuf, ASSET_CACHE_DEFAULT_BUDGET);
+    asset_cache_add(&app->screenAssets, "images/help.png", ASSET_TEXTURE);
+    asset_cache_add(&app->screenAssets, "images/scoreboard.png", ASSET_TEXTURE);
+    asset_cache_add(&app->screenAssets, "images/pause.png", ASSET_TEXTURE);
+    asset_cache_add(&app->screenAssets, "images/game_over.png", ASSET_TEXTURE);
+    asset_cache_add(&app->screenAssets, "images/game_complete.png", ASSET_TEXTURE);
+    asset_cache_add(&app->screenAssets, "sounds/win.wav", ASSET_MUSIC);
 
     if (base) SDL_free(base);
 
     center_texture_rect(&app->ui.menu.title,0.575f, -200);
-    center_texture_rect(&app->ui.overlay.gameOver,0.5f,0);
-    center_texture_rect(&app->ui.overlay.pause,0.4f,0 );
-    center_texture_rect(&app->ui.overlay.gameWin, 0.4f,0);
-    center_texture_rect(&app->ui.scoreboard.rankingImg,0.4f,0);
-    SDL_QueryTexture(app->ui.help.helpImg, NULL, NULL, &app->ui.help.textW,&app->ui.help.textH);
-
-    create_text_texture(&app->ui.menu.play, STANDARD,WHITE,app);
-    create_text_texture(&app->ui.menu.help, STANDARD,WHITE,app);
-    create_text_texture(&app->ui.menu.exit, STANDARD,WHITE,app);
-    create_text_texture(&app->ui.menu.rank, STANDARD,WHITE,app);
-    create_text_texture(&app->ui.menu.credit, SMALL,GREY,app);
-    create_text_texture(&app->ui.overlay.score, STANDARD,WHITE,app);
-    create_text_texture(&app->ui.overlay.lives, STANDARD,WHITE,app);
-    create_text_texture(&app->ui.overlay.ready, STANDARD,WHITE,app);
-    create_text_texture(&app->ui.scoreboard.hint, STANDARD,WHITE,app);
 
+    layout_text(&app->ui.menu.play, STANDARD,WHITE,app);
+    layout_text(&app->ui.menu.help, STANDARD,WHITE,app);
+    layout_text(&app->ui.menu.exit, STANDARD,WHITE,app);
+    layout_text(&app->ui.menu.rank, STANDARD,WHITE,app);
+    layout_text(&app->ui.menu.credit, SMALL,GREY,app);
+    layout_text(&app->ui.overlay.score, STANDARD,WHITE,app);
+    layout_text(&app->ui.overlay.lives, STANDARD,WHITE,app);
+    layout_text(&app->ui.overlay.ready, STANDARD,WHITE,app);
+    layout_text(&app->ui.scoreboard.hint, STANDARD,WHITE,app);
+
+    core_init(&app->game, (uint32_t)time(NULL));
+    reset_motion(app);
     app->game.state = STATE_MENU;
     app->game.prevState = STATE_PLAYING;
+    app->input = DIR_COUNT;
     app->isRunning = true;
     app->timer.lastTicks = SDL_GetTicks();
+    scheduler_init(&app->timer.ticks, 1, TICK_RATE);
 
-    srand((unsigned int)time(NULL));
-    load_scores(&app->game.board);
+    // Draw as often as the display refreshes, whatever the tick rate
+    SDL_DisplayMode mode;
+    int refresh = SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(app->window), &mode) == 0 ? mode.refresh_rate : 0;
+    scheduler_init(&app->timer.frames, 1, refresh > 0 ? (uint32_t)refresh : TARGET_FPS);
+
+    load_scores(&app->board);
 }
 
 void quit_game_application(AppContext *app) {
     if (!app) return;
 
-    save_scores(&app->game.board);
+    save_scores(&app->board);
 
     /* -------- TEXTURES (TEXT) -------- */
-    safe_destroy_texture(&app->ui.menu.play.texture);
-    safe_destroy_texture(&app->ui.menu.help.texture);
-    safe_destroy_texture(&app->ui.menu.rank.texture);
-    safe_destroy_texture(&app->ui.menu.exit.texture);
-    safe_destroy_texture(&app->ui.menu.credit.texture);
-
-    safe_destroy_texture(&app->ui.overlay.score.texture);
-    safe_destroy_texture(&app->ui.overlay.lives.texture);
-    safe_destroy_texture(&app->ui.overlay.ready.texture);
-
-    safe_destroy_texture(&app->ui.scoreboard.hint.texture);
-    safe_destroy_texture(&app->ui.scoreboard.names.texture);
-    safe_destroy_texture(&app->ui.scoreboard.scores.texture);
-
-    safe_destroy_texture(&app->game.player.playerName.texture);
+    glyph_atlas_free(&app->glyphs);
 
     /* -------- TEXTURES (IMAGES) -------- */
+    safe_destroy_texture(&app->mazeLayer.texture);
     safe_destroy_texture(&app->spritesheet);
-    safe_destroy_texture(&app->ui.help.helpImg);
     safe_destroy_texture(&app->ui.menu.title.img);
-    safe_destroy_texture(&app->ui.overlay.gameOver.img);
-    safe_destroy_texture(&app->ui.overlay.pause.img);
-    safe_destroy_texture(&app->ui.overlay.gameWin.img);
-    safe_destroy_texture(&app->ui.scoreboard.rankingImg.img);
+    asset_cache_free(&app->screenAssets); // screen images and the streamed win sound
 
     /* -------- SOUNDS -------- */
     safe_free_chunk(&app->sounds.death);
     safe_free_chunk(&app->sounds.eatDot);
     safe_free_chunk(&app->sounds.eatGhost);
     safe_free_chunk(&app->sounds.move);
-    safe_free_chunk(&app->sounds.win);
     safe_free_chunk(&app->sounds.start);
 
     /* -------- TEXT MEMORY -------- */
@@ -947,18 +1343,21 @@ void quit_game_application(AppContext *app) {
     safe_free((void**)&app->ui.scoreboard.names.text);
     safe_free((void**)&app->ui.scoreboard.scores.text);
 
-    safe_free((void**)&app->game.player.playerName.text);
+    safe_free((void**)&app->ui.scoreboard.playerName.text);
 
     /* -------- SDL OBJECTS -------- */
     if (app->font) {
         TTF_CloseFont(app->font);
         app->font = NULL;
     }
+    archive_close(&app->assets); // after the font and chunks that read from it
 
     if (app->renderer) {
         SDL_DestroyRenderer(app->renderer);
         app->renderer = NULL;
     }
+    soft_frame_free(&app->soft); // the window surface goes with the window
+
 
     if (app->window) {
         SDL_DestroyWindow(app->window);
@@ -974,7 +1373,7 @@ void quit_game_application(AppContext *app) {
 
 // ---------------- EVENTS HANDLERS ---------------
 static void handle_enter_name_events(AppContext *app) {
-    TextLabel *nameLabel = &app->game.player.playerName;
+    TextLabel *nameLabel = &app->ui.scoreboard.playerName;
     SDL_Keycode key = app->event.key.keysym.sym;
     uint8_t len = strlen(nameLabel->text);
     // Handle backspace
@@ -984,9 +1383,9 @@ static void handle_enter_name_events(AppContext *app) {
     }
     // Handle enter/space to confirm name
     else if ((key == SDLK_RETURN || key == SDLK_SPACE) && len > 0) {
-        app->timer.startPauseTicks = SDL_GetTicks();
-        init_level(&app->game,false);  // Start new game
-        app->game.state = STATE_START_LEVEL;
+        core_init_level(&app->game,false);  // Start new game
+        reset_motion(app);
+        app->mazeLayer.rebuild = true;
         SDL_StopTextInput();
     }
     // Handle valid character input
@@ -998,19 +1397,17 @@ static void handle_enter_name_events(AppContext *app) {
 }
 
 static void handle_playing_events(AppContext *app) {
-    GameEntity *pacman = &app->game.player.pacman;
     SDL_Keycode key = app->event.key.keysym.sym;
 
-    // Handle movement keys
+    // Handle movement keys, applied on the next simulation tick
     switch (key) {
-        case SDLK_UP:    pacman->dir = DIR_UP;    break;
-        case SDLK_DOWN:  pacman->dir = DIR_DOWN;  break;
-        case SDLK_LEFT:  pacman->dir = DIR_LEFT;  break;
-        case SDLK_RIGHT: pacman->dir = DIR_RIGHT; break;
+        case SDLK_UP:    app->input = DIR_UP;    break;
+        case SDLK_DOWN:  app->input = DIR_DOWN;  break;
+        case SDLK_LEFT:  app->input = DIR_LEFT;  break;
+        case SDLK_RIGHT: app->input = DIR_RIGHT; break;
             
         case SDLK_ESCAPE:  // Pause game
             app->game.state = STATE_PAUSED;
-            app->timer.startPauseTicks = SDL_GetTicks();
             break;
         default:
             break;
@@ -1027,7 +1424,7 @@ static void handle_menu_events(AppContext *app) {
             
         case SDLK_s:  // Start game
             app->game.state = STATE_ENTER_NAME;
-            app->game.player.playerName.needsUpdate = true;
+            app->ui.scoreboard.playerName.needsUpdate = true;
             SDL_StartTextInput();
             break;
 
@@ -1048,13 +1445,11 @@ static void handle_paused_events(AppContext *app) {
     SDL_Keycode key = app->event.key.keysym.sym;
 
     if (key == SDLK_ESCAPE) {  // Return to menu
-        add_score_to_board(&app->game);
+        if (app->world) leave_world(app);
+        else add_score_to_board(app);
         app->game.state = STATE_MENU;
     }
-    else if (key == SDLK_s) {  // Resume game
-        // Adjust game timer for time spent paused
-        uint32_t pauseDuration = SDL_GetTicks() - app->timer.startPauseTicks;
-        app->timer.accumulator -= pauseDuration;  // Convert ms to seconds
+    else if (key == SDLK_s) {  // Resume game, ticks are only run while playing so no time is owed
         app->game.state = STATE_PLAYING;
     }
 }
@@ -1067,6 +1462,18 @@ void handle_events(AppContext *app) {
         app->isRunning = false;
         return;
     }
+    if (event->type == SDL_RENDER_TARGETS_RESET || event->type == SDL_RENDER_DEVICE_RESET) {
+        app->mazeLayer.rebuild = true; // target texture contents are lost
+        return;
+    }
+    if (event->type == SDL_WINDOWEVENT && event->window.event == SDL_WINDOWEVENT_EXPOSED) {
+        // Static screens are drawn once on entry, draw them again. prevState
+        // stays: the timed screens would start their timelines over.
+        app->needsRedraw = true;
+        app->soft.boardShown = false; // --soft: the next board frame is pushed whole
+        app->ui.scoreboard.playerName.needsUpdate = true;
+        return;
+    }
     if(event->type != SDL_KEYDOWN) return;
     switch (app->game.state) {
         case STATE_ENTER_NAME:
@@ -1096,39 +1503,3 @@ void handle_events(AppContext *app) {
             break;
     }
 }
-
-
-int main() {
-    AppContext app;
-    init_game_application(&app);
-    while (app.isRunning) {
-        // Calculate frame time
-        uint32_t currentTicks = SDL_GetTicks();
-        app.timer.accumulator += currentTicks - app.timer.lastTicks;
-        app.sounds.dotTimer += currentTicks - app.timer.lastTicks;
-        app.sounds.moveTimer += currentTicks - app.timer.lastTicks;
-        app.timer.lastTicks = currentTicks;
-        
-        // Event handling
-        while (SDL_PollEvent(&app.event)) {
-            handle_events(&app);
-        }
-        
-        // Game state updates
-        if(app.game.state == STATE_PLAYING){
-            update_game(&app);
-        }
-
-        // Rendering
-        render(&app);
-        
-        // Frame rate control
-        uint32_t frameTime = SDL_GetTicks() - currentTicks;
-        if (frameTime < DELTA_TICK_MS) {
-            SDL_Delay(DELTA_TICK_MS - frameTime);
-        }
-    }
-    
-    quit_game_application(&app);
-    return EXIT_SUCCESS;
-}
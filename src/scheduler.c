@@ -0,0 +1,70 @@
+#include "scheduler.h"
+#include <string.h>
+
+void scheduler_init(Scheduler *scheduler, uint32_t num, uint32_t den) {
+    memset(scheduler, 0, sizeof(Scheduler));
+    scheduler->freq = SDL_GetPerformanceFrequency();
+    scheduler->num = num;
+    scheduler->den = den;
+    scheduler->step = scheduler->freq * num / den;
+    scheduler->stepRem = (uint32_t)(scheduler->freq * num % den);
+    scheduler->spin = scheduler->freq * SCHEDULER_SPIN_US / 1000000;
+    scheduler->next = SDL_GetPerformanceCounter() + scheduler->step;
+}
+
+static void next_deadline(Scheduler *scheduler) {
+    scheduler->next += scheduler->step;
+    scheduler->carry += scheduler->stepRem;
+    if (scheduler->carry >= scheduler->den) {
+        scheduler->carry -= scheduler->den;
+        scheduler->next++;
+    }
+}
+
+uint32_t scheduler_due(Scheduler *scheduler) {
+    uint64_t now = SDL_GetPerformanceCounter();
+    if (now < scheduler->next) return 0;
+
+    uint64_t late = now - scheduler->next;
+    if (late > scheduler->lateMax) scheduler->lateMax = late;
+    scheduler->lateSum += late;
+    scheduler->lateCount++;
+
+    uint32_t due = 0;
+    while (now >= scheduler->next && due < SCHEDULER_MAX_CATCH_UP) {
+        next_deadline(scheduler);
+        due++;
+    }
+    if (now >= scheduler->next) {
+        // A long stall (window drag, breakpoint): skip the backlog in one go
+        uint64_t skipped = (now - scheduler->next) / scheduler->step + 1;
+        scheduler->dropped += skipped;
+        scheduler->next += skipped * scheduler->step;
+    }
+    scheduler->ticks += due;
+    return due;
+}
+
+void scheduler_resync(Scheduler *scheduler) {
+    scheduler->next = SDL_GetPerformanceCounter() + scheduler->step;
+    scheduler->carry = 0;
+}
+
+float scheduler_alpha(const Scheduler *scheduler) {
+    uint64_t now = SDL_GetPerformanceCounter();
+    if (now >= scheduler->next) return 1.0f;
+
+    uint64_t left = scheduler->next - now;
+    return left >= scheduler->step ? 0.0f : 1.0f - (float)left / scheduler->step;
+}
+
+void scheduler_wait(Scheduler *scheduler) {
+    uint64_t now = SDL_GetPerformanceCounter();
+    if (now >= scheduler->next) return;
+
+    uint64_t left = scheduler->next - now;
+    if (left > scheduler->spin) SDL_Delay((uint32_t)((left - scheduler->spin) * 1000 / scheduler->freq));
+    while (SDL_GetPerformanceCounter() < scheduler->next) {
+        // The sleep above lands within a millisecond or two; finish on the counter
+    }
+}
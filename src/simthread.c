@@ -0,0 +1,144 @@
+#include "simthread.h"
+#include <string.h>
+
+#define SIM_SLOT_FRESH 4
+
+enum { SESSION_IDLE, SESSION_RUNNING, SESSION_STOPPING };
+
+static void publish(SimThread *sim) {
+    SimSnapshot *slot = &sim->slots[sim->back];
+    slot->game = sim->game;
+    slot->clock = sim->clock;
+    memcpy(slot->eventCounts, sim->eventCounts, sizeof(slot->eventCounts));
+
+    SDL_MemoryBarrierRelease();
+    sim->back = SDL_AtomicSet(&sim->latest, sim->back | SIM_SLOT_FRESH) & 3;
+}
+
+static bool pop_input(SimThread *sim, Direction *dir) {
+    int tail = SDL_AtomicGet(&sim->tail);
+    if (tail == SDL_AtomicGet(&sim->head)) return false;
+
+    SDL_MemoryBarrierAcquire();
+    *dir = (Direction)sim->input[tail & (SIM_INPUT_SLOTS - 1)];
+    SDL_AtomicSet(&sim->tail, tail + 1);
+    return true;
+}
+
+static void count_events(SimThread *sim, uint32_t events) {
+    for (int bit = 0; bit < SIM_EVENT_BITS; bit++) {
+        if ((events >> bit) & 1) sim->eventCounts[bit]++;
+    }
+}
+
+// One frame's worth of the single threaded update_game(), minus the reactions:
+// those run on the main thread from the published counts.
+static void run_ticks(SimThread *sim, uint32_t ticks, Direction input) {
+    while (ticks > 0 && sim->game.state == STATE_PLAYING) {
+        uint32_t done;
+        count_events(sim, core_advance(&sim->game, ticks, input, UINT32_MAX, &done));
+        ticks -= done;
+        input = DIR_COUNT;
+    }
+}
+
+static int sim_main(void *data) {
+    SimThread *sim = data;
+    bool playing = false;
+
+    while (!SDL_AtomicGet(&sim->quit)) {
+        int session = SDL_AtomicGet(&sim->session);
+        if (!playing) {
+            // A session stopped before it got going still ends through the code below
+            if (session == SESSION_IDLE) {
+                SDL_SemWait(sim->wake);
+                continue;
+            }
+            SDL_MemoryBarrierAcquire();
+            scheduler_init(&sim->clock, 1, sim->tickRate);
+            playing = true;
+        }
+
+        if (session == SESSION_RUNNING && sim->game.state == STATE_PLAYING) {
+            uint32_t ticks = scheduler_due(&sim->clock);
+            if (ticks == 0) {
+                scheduler_wait(&sim->clock);
+                continue;
+            }
+
+            // Only the latest direction counts, as with a single pending input
+            Direction input = DIR_COUNT, dir;
+            while (pop_input(sim, &dir)) input = dir;
+            run_ticks(sim, ticks, input);
+            publish(sim);
+            if (sim->game.state == STATE_PLAYING) continue;
+        } else {
+            publish(sim);
+        }
+
+        // Hand the game back: the final snapshot is already out
+        playing = false;
+        SDL_MemoryBarrierRelease();
+        SDL_AtomicSet(&sim->session, SESSION_IDLE);
+    }
+    return 0;
+}
+
+bool sim_thread_start(SimThread *sim, uint32_t tickRate) {
+    memset(sim, 0, sizeof(SimThread));
+    sim->tickRate = tickRate;
+    sim->back = 0;
+    sim->front = 2;
+    SDL_AtomicSet(&sim->latest, 1);
+
+    sim->wake = SDL_CreateSemaphore(0);
+    if (!sim->wake) return false;
+    sim->thread = SDL_CreateThread(sim_main, "sim", sim);
+    return sim->thread != NULL;
+}
+
+void sim_thread_quit(SimThread *sim) {
+    if (!sim->thread) return;
+    SDL_AtomicSet(&sim->quit, 1);
+    SDL_SemPost(sim->wake);
+    SDL_WaitThread(sim->thread, NULL);
+    SDL_DestroySemaphore(sim->wake);
+    sim->thread = NULL;
+}
+
+void sim_thread_play(SimThread *sim, const GameLogic *game) {
+    // A session the sim thread just ended is only idle once its snapshot is out
+    while (SDL_AtomicGet(&sim->session) != SESSION_IDLE) SDL_Delay(0);
+    SDL_MemoryBarrierAcquire();
+
+    // Directions queued after the last session ended are stale
+    SDL_AtomicSet(&sim->tail, SDL_AtomicGet(&sim->head));
+    sim->game = *game;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&sim->session, SESSION_RUNNING);
+    SDL_SemPost(sim->wake);
+}
+
+void sim_thread_stop(SimThread *sim) {
+    SDL_AtomicCAS(&sim->session, SESSION_RUNNING, SESSION_STOPPING);
+    while (SDL_AtomicGet(&sim->session) != SESSION_IDLE) SDL_Delay(0);
+    SDL_MemoryBarrierAcquire();
+}
+
+bool sim_thread_input(SimThread *sim, Direction dir) {
+    int head = SDL_AtomicGet(&sim->head);
+    if (head - SDL_AtomicGet(&sim->tail) == SIM_INPUT_SLOTS) return false;
+
+    sim->input[head & (SIM_INPUT_SLOTS - 1)] = (uint8_t)dir;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&sim->head, head + 1);
+    return true;
+}
+
+const SimSnapshot *sim_thread_latest(SimThread *sim) {
+    if (!(SDL_AtomicGet(&sim->latest) & SIM_SLOT_FRESH)) return NULL;
+
+    sim->front = SDL_AtomicSet(&sim->latest, sim->front) & 3;
+    SDL_MemoryBarrierAcquire();
+    return &sim->slots[sim->front];
+}
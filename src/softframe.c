@@ -0,0 +1,175 @@
+#include "softframe.h"
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+bool soft_frame_init(SoftFrame *soft, SDL_Window *window) {
+    memset(soft, 0, sizeof(SoftFrame));
+    soft->window = window;
+    soft->surface = SDL_GetWindowSurface(window);
+    soft->full = true;
+    return soft->surface != NULL;
+}
+
+bool soft_frame_sheet(SoftFrame *soft, SDL_Surface *pixels) {
+    soft->sheet = SDL_ConvertSurface(pixels, soft->surface->format, 0);
+    if (!soft->sheet) return false;
+    SDL_SetSurfaceBlendMode(soft->sheet, SDL_BLENDMODE_NONE); // the atlas is opaque
+    return true;
+}
+
+bool soft_frame_board(SoftFrame *soft, const SDL_Rect *dst) {
+    const SDL_PixelFormat *format = soft->surface->format;
+    soft->board = SDL_CreateRGBSurfaceWithFormat(0, dst->w, dst->h, format->BitsPerPixel, format->format);
+    if (!soft->board) return false;
+    SDL_SetSurfaceBlendMode(soft->board, SDL_BLENDMODE_NONE);
+    SDL_FillRect(soft->board, NULL, SDL_MapRGB(format, 0, 0, 0));
+    soft->boardDst = *dst;
+    return true;
+}
+
+void soft_frame_free(SoftFrame *soft) {
+    if (soft->sheet) SDL_FreeSurface(soft->sheet);
+    if (soft->board) SDL_FreeSurface(soft->board);
+    memset(soft, 0, sizeof(SoftFrame)); // the window surface belongs to the window
+}
+
+// Eight 32-bit pixels per source row, each written to a 2x2 block.
+static void double_cell(uint8_t *dst, int dstPitch, const uint8_t *src, int srcPitch) {
+    for (int y = 0; y < SOFT_CELL; y++, src += srcPitch, dst += 2 * dstPitch) {
+        const uint32_t *in = (const uint32_t *)src;
+        uint32_t *out0 = (uint32_t *)dst, *out1 = (uint32_t *)(dst + dstPitch);
+#if defined(__AVX2__)
+        __m256i row = _mm256_loadu_si256((const __m256i *)in);
+        __m256i lo = _mm256_permutevar8x32_epi32(row, _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3));
+        __m256i hi = _mm256_permutevar8x32_epi32(row, _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7));
+        _mm256_storeu_si256((__m256i *)out0, lo);
+        _mm256_storeu_si256((__m256i *)(out0 + 8), hi);
+        _mm256_storeu_si256((__m256i *)out1, lo);
+        _mm256_storeu_si256((__m256i *)(out1 + 8), hi);
+#elif defined(__SSE2__)
+        __m128i a = _mm_loadu_si128((const __m128i *)in), b = _mm_loadu_si128((const __m128i *)(in + 4));
+        __m128i p0 = _mm_unpacklo_epi32(a, a), p1 = _mm_unpackhi_epi32(a, a);
+        __m128i p2 = _mm_unpacklo_epi32(b, b), p3 = _mm_unpackhi_epi32(b, b);
+        _mm_storeu_si128((__m128i *)out0, p0);
+        _mm_storeu_si128((__m128i *)(out0 + 4), p1);
+        _mm_storeu_si128((__m128i *)(out0 + 8), p2);
+        _mm_storeu_si128((__m128i *)(out0 + 12), p3);
+        _mm_storeu_si128((__m128i *)out1, p0);
+        _mm_storeu_si128((__m128i *)(out1 + 4), p1);
+        _mm_storeu_si128((__m128i *)(out1 + 8), p2);
+        _mm_storeu_si128((__m128i *)(out1 + 12), p3);
+#else
+        for (int x = 0; x < SOFT_CELL; x++) out0[2*x] = out0[2*x+1] = out1[2*x] = out1[2*x+1] = in[x];
+#endif
+    }
+}
+
+// The same doubling, pixel by pixel, for cells cut by the clip rect.
+static void double_cell_clipped(SDL_Surface *dst, const SDL_Surface *sheet, const SDL_Rect *cell, const SDL_Rect *dstRect) {
+    SDL_Rect area;
+    if (!SDL_IntersectRect(dstRect, &dst->clip_rect, &area)) return;
+    for (int y = area.y; y < area.y + area.h; y++) {
+        const uint32_t *in = (const uint32_t *)((const uint8_t *)sheet->pixels + (cell->y + ((y - dstRect->y) >> 1)) * sheet->pitch) + cell->x;
+        uint32_t *out = (uint32_t *)((uint8_t *)dst->pixels + y * dst->pitch);
+        for (int x = area.x; x < area.x + area.w; x++) out[x] = in[(x - dstRect->x) >> 1];
+    }
+}
+
+void soft_blit_cell(SDL_Surface *dst, const SDL_Surface *sheet, const SDL_Rect *cell, const SDL_Rect *dstRect) {
+    bool doubled = cell->w == SOFT_CELL && cell->h == SOFT_CELL && dstRect->w == 2 * SOFT_CELL && dstRect->h == 2 * SOFT_CELL;
+    if (!doubled || dst->format->BytesPerPixel != 4 || sheet->format->BytesPerPixel != 4) {
+        SDL_Rect to = *dstRect; // SDL writes the clipped rect back
+        SDL_BlitScaled((SDL_Surface *)sheet, cell, dst, &to);
+        return;
+    }
+
+    const SDL_Rect *clip = &dst->clip_rect;
+    if (dstRect->x < clip->x || dstRect->y < clip->y ||
+        dstRect->x + dstRect->w > clip->x + clip->w || dstRect->y + dstRect->h > clip->y + clip->h) {
+        double_cell_clipped(dst, sheet, cell, dstRect);
+        return;
+    }
+    double_cell((uint8_t *)dst->pixels + dstRect->y * dst->pitch + dstRect->x * 4, dst->pitch,
+                (const uint8_t *)sheet->pixels + cell->y * sheet->pitch + cell->x * 4, sheet->pitch);
+}
+
+// Touching or overlapping rects merge: the glyphs of a label, a sprite and where it was.
+static bool add_rect(const SoftFrame *soft, SDL_Rect *list, int *count, const SDL_Rect *rect) {
+    SDL_Rect bounds = {0, 0, soft->surface->w, soft->surface->h}, r;
+    if (!SDL_IntersectRect(rect, &bounds, &r)) return true;
+
+    for (int i = 0; i < *count; i++) {
+        SDL_Rect grown = {list[i].x - 1, list[i].y - 1, list[i].w + 2, list[i].h + 2};
+        if (SDL_HasIntersection(&grown, &r)) {
+            SDL_UnionRect(&list[i], &r, &list[i]);
+            return true;
+        }
+    }
+    if (*count == SOFT_RECTS_MAX) return false;
+    list[(*count)++] = r;
+    return true;
+}
+
+void soft_frame_mark(SoftFrame *soft, const SDL_Rect *rect) {
+    if (!rect || !add_rect(soft, soft->drawn, &soft->drawnCount, rect)) soft->full = soft->untracked = true;
+}
+
+void soft_frame_dirty(SoftFrame *soft, const SDL_Rect *rect) {
+    if (!add_rect(soft, soft->dirty, &soft->dirtyCount, rect)) soft->full = true;
+}
+
+// Black, then the board where the area overlaps it; NULL is the whole surface.
+static void put_background(SoftFrame *soft, const SDL_Rect *rect) {
+    SDL_Rect area = rect ? *rect : (SDL_Rect){0, 0, soft->surface->w, soft->surface->h}, part;
+    SDL_FillRect(soft->surface, &area, SDL_MapRGB(soft->surface->format, 0, 0, 0));
+    if (soft->board && SDL_IntersectRect(&area, &soft->boardDst, &part)) {
+        SDL_Rect src = {part.x - soft->boardDst.x, part.y - soft->boardDst.y, part.w, part.h};
+        SDL_BlitSurface(soft->board, &src, soft->surface, &part);
+    }
+}
+
+void soft_frame_restore(SoftFrame *soft) {
+    if (!soft->boardShown) soft->full = true; // something else is on screen
+    soft->restored = true;
+    if (soft->full) {
+        put_background(soft, NULL);
+        return;
+    }
+    for (int i = 0; i < soft->shownCount; i++) put_background(soft, &soft->shown[i]);
+    for (int i = 0; i < soft->dirtyCount; i++) put_background(soft, &soft->dirty[i]);
+}
+
+void soft_frame_present(SoftFrame *soft, SDL_Renderer *renderer) {
+#if SDL_VERSION_ATLEAST(2, 0, 10)
+    SDL_RenderFlush(renderer); // the software renderer queues its draws until now
+#else
+    (void)renderer;
+#endif
+    if (!soft->restored) soft->full = true; // drawn from scratch, nothing was tracked
+
+    SDL_Rect push[SOFT_RECTS_MAX];
+    int pushCount = 0;
+    bool ok = !soft->full;
+    for (int i = 0; ok && i < soft->shownCount; i++) ok = add_rect(soft, push, &pushCount, &soft->shown[i]);
+    for (int i = 0; ok && i < soft->drawnCount; i++) ok = add_rect(soft, push, &pushCount, &soft->drawn[i]);
+    for (int i = 0; ok && i < soft->dirtyCount; i++) ok = add_rect(soft, push, &pushCount, &soft->dirty[i]);
+
+    if (ok) {
+        SDL_UpdateWindowSurfaceRects(soft->window, push, pushCount);
+        for (int i = 0; i < pushCount; i++) soft->pushed += (uint32_t)(push[i].w * push[i].h);
+    } else {
+        SDL_UpdateWindowSurface(soft->window);
+        soft->pushed += (uint32_t)(soft->surface->w * soft->surface->h);
+    }
+
+    memcpy(soft->shown, soft->drawn, sizeof(SDL_Rect) * soft->drawnCount);
+    soft->shownCount = soft->drawnCount;
+    soft->drawnCount = soft->dirtyCount = 0;
+    soft->boardShown = soft->restored && !soft->untracked; // else the next restore would miss some
+    soft->restored = soft->full = soft->untracked = false;
+}
@@ -0,0 +1,84 @@
+#include "sprites.h"
+#include <string.h>
+
+void sprite_batch_init(SpriteBatch *batch, SDL_Renderer *renderer, SDL_Texture *texture, uint32_t *drawCalls) {
+    int texW = 1, texH = 1;
+
+    memset(batch, 0, sizeof(SpriteBatch));
+    batch->renderer = renderer;
+    batch->texture = texture;
+    batch->drawCalls = drawCalls;
+    SDL_QueryTexture(texture, NULL, NULL, &texW, &texH);
+    batch->texelW = 1.0f / texW;
+    batch->texelH = 1.0f / texH;
+
+    for (int i = 0; i < SPRITE_BATCH_MAX; i++) {
+        int *quad = &batch->indices[i * 6];
+        quad[0] = i * 4;     quad[1] = i * 4 + 1; quad[2] = i * 4 + 2;
+        quad[3] = i * 4 + 2; quad[4] = i * 4 + 1; quad[5] = i * 4 + 3;
+    }
+}
+
+void sprite_batch_add_tinted(SpriteBatch *batch, const SDL_Rect *src, const SDL_Rect *dst, SDL_Color tint) {
+    if (batch->count == SPRITE_BATCH_MAX) sprite_batch_flush(batch);
+    batch->src[batch->count] = *src;
+    batch->dst[batch->count] = *dst;
+    batch->tint[batch->count] = tint;
+    batch->count++;
+}
+
+void sprite_batch_add(SpriteBatch *batch, const SDL_Rect *src, const SDL_Rect *dst) {
+    const SDL_Color white = {255, 255, 255, 255};
+    sprite_batch_add_tinted(batch, src, dst, white);
+}
+
+static void count_draw(SpriteBatch *batch) {
+    if (batch->drawCalls) (*batch->drawCalls)++;
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+// Corners in order top-left, top-right, bottom-left, bottom-right.
+static void fill_vertices(SpriteBatch *batch) {
+    for (int i = 0; i < batch->count; i++) {
+        const SDL_Rect *src = &batch->src[i], *dst = &batch->dst[i];
+        float u0 = src->x * batch->texelW, u1 = (src->x + src->w) * batch->texelW;
+        float v0 = src->y * batch->texelH, v1 = (src->y + src->h) * batch->texelH;
+        float x0 = (float)dst->x, x1 = (float)(dst->x + dst->w);
+        float y0 = (float)dst->y, y1 = (float)(dst->y + dst->h);
+        SDL_Color tint = batch->tint[i];
+        SDL_Vertex *v = &batch->vertices[i * 4];
+
+        v[0] = (SDL_Vertex){{x0, y0}, tint, {u0, v0}};
+        v[1] = (SDL_Vertex){{x1, y0}, tint, {u1, v0}};
+        v[2] = (SDL_Vertex){{x0, y1}, tint, {u0, v1}};
+        v[3] = (SDL_Vertex){{x1, y1}, tint, {u1, v1}};
+    }
+}
+#endif
+
+void sprite_batch_flush(SpriteBatch *batch) {
+    if (batch->count == 0) return;
+    if (batch->onSubmit) batch->onSubmit(batch->onSubmitContext, batch->dst, batch->count);
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (!batch->noGeometry) {
+        fill_vertices(batch);
+        if (SDL_RenderGeometry(batch->renderer, batch->texture, batch->vertices, batch->count * 4,
+                               batch->indices, batch->count * 6) == 0) {
+            count_draw(batch);
+            batch->count = 0;
+            return;
+        }
+        batch->noGeometry = true;
+    }
+#endif
+
+    for (int i = 0; i < batch->count; i++) {
+        SDL_Color tint = batch->tint[i];
+        SDL_SetTextureColorMod(batch->texture, tint.r, tint.g, tint.b);
+        SDL_RenderCopy(batch->renderer, batch->texture, &batch->src[i], &batch->dst[i]);
+        count_draw(batch);
+    }
+    SDL_SetTextureColorMod(batch->texture, 255, 255, 255);
+    batch->count = 0;
+}
@@ -0,0 +1,50 @@
+#include "startup.h"
+#include <stdio.h>
+#include <string.h>
+
+static double ms_since(const StartupLog *log, uint64_t counter) {
+    return (double)(counter - log->begin) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+void startup_begin(StartupLog *log) {
+    memset(log, 0, sizeof(StartupLog));
+    log->begin = SDL_GetPerformanceCounter();
+}
+
+int startup_stage_begin(StartupLog *log, const char *name, const char *thread) {
+    int stage = SDL_AtomicAdd(&log->count, 1);
+    if (stage >= STARTUP_MAX_STAGES) return -1;
+
+    log->stages[stage].name = name;
+    log->stages[stage].thread = thread;
+    log->stages[stage].start = SDL_GetPerformanceCounter();
+    return stage;
+}
+
+void startup_stage_end(StartupLog *log, int stage) {
+    if (stage >= 0) log->stages[stage].end = SDL_GetPerformanceCounter();
+}
+
+void startup_print(StartupLog *log, const char *milestone) {
+    if (log->printed) return;
+    log->printed = true;
+
+    // Workers are joined by now; only the order of the slots is theirs
+    int count = SDL_AtomicGet(&log->count);
+    if (count > STARTUP_MAX_STAGES) count = STARTUP_MAX_STAGES;
+    bool shown[STARTUP_MAX_STAGES] = {false};
+
+    printf("startup:    at ms   took ms  thread  stage\n");
+    for (int n = 0; n < count; n++) {
+        int next = -1;
+        for (int i = 0; i < count; i++) {
+            if (!shown[i] && (next < 0 || log->stages[i].start < log->stages[next].start)) next = i;
+        }
+        const StartupStage *stage = &log->stages[next];
+        shown[next] = true;
+        printf("startup: %8.1f %9.1f  %-6s  %s\n", ms_since(log, stage->start),
+               ms_since(log, stage->end) - ms_since(log, stage->start), stage->thread, stage->name);
+    }
+    printf("startup: %8.1f            %s\n", ms_since(log, SDL_GetPerformanceCounter()), milestone);
+    fflush(stdout);
+}
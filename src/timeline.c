@@ -0,0 +1,20 @@
+#include "timeline.h"
+
+void timeline_start(Timeline *timeline, uint16_t steps, uint32_t stepMs) {
+    timeline->elapsedMs = 0;
+    timeline->stepMs = stepMs ? stepMs : 1;
+    timeline->steps = steps ? steps : 1;
+    timeline->done = false;
+}
+
+bool timeline_advance(Timeline *timeline, uint32_t deltaMs) {
+    if (timeline->done) return false;
+
+    uint32_t duration = timeline->stepMs * timeline->steps;
+    timeline->elapsedMs += deltaMs;
+    if (timeline->elapsedMs < duration) return false;
+
+    timeline->elapsedMs = duration;
+    timeline->done = true;
+    return true;
+}
@@ -0,0 +1,313 @@
+/* Sprite atlas packer: tools/atlas.txt and sprites.png in, a tight atlas PNG
+ * and include/atlas.h out. Only the cells the manifest names are kept, each
+ * distinct picture once, shelf packed into the smallest sheet found; the
+ * header gives every table the cells' places in the atlas. -s N pre-scales
+ * the cells N times, nearest neighbour, for renderers that draw at 1:1. */
+
+#define SDL_MAIN_HANDLED
+#if defined(_WIN32) || defined(__APPLE__)
+#include <SDL.h>
+#include <SDL_image.h>
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ATLAS_MAX_CELLS 2048
+#define ATLAS_MAX_TABLES 8
+#define ATLAS_MAX_SIDE 4096
+
+typedef struct {
+  int x, y, w, h; // in the atlas, already scaled
+  uint32_t *pixels;
+} Picture;
+
+typedef struct {
+  int picture; // -1 for an empty clip
+} Cell;
+
+typedef struct {
+  char name[32];
+  int first, count; // cells[first .. first+count-1]
+  bool grid;
+  int cols, rows;   // grid only
+  SDL_Rect sheet;   // grid only: origin and cell size in the sheet
+} Table;
+
+static Picture pictures[ATLAS_MAX_CELLS];
+static int pictureCount;
+static Cell cells[ATLAS_MAX_CELLS];
+static int cellCount;
+static Table tables[ATLAS_MAX_TABLES];
+static int tableCount;
+
+static SDL_Surface *sheet; // RGBA32
+static int scale = 1;
+
+// Cut, scale and deduplicate one cell.
+static bool add_cell(int x, int y, int w, int h) {
+    if (cellCount == ATLAS_MAX_CELLS) return false;
+    Cell *cell = &cells[cellCount++];
+    cell->picture = -1;
+    if (w == 0 || h == 0) return true;
+    if (x < 0 || y < 0 || w < 0 || h < 0 || x + w > sheet->w || y + h > sheet->h) return false;
+
+    int sw = w * scale, sh = h * scale;
+    uint32_t *pixels = malloc((size_t)sw * sh * sizeof(uint32_t));
+    if (!pixels) return false;
+    for (int py = 0; py < sh; py++) {
+        const uint32_t *row = (const uint32_t *)((const uint8_t *)sheet->pixels + (size_t)(y + py / scale) * sheet->pitch);
+        for (int px = 0; px < sw; px++) pixels[py * sw + px] = row[x + px / scale];
+    }
+
+    for (int i = 0; i < pictureCount; i++) {
+        if (pictures[i].w == sw && pictures[i].h == sh && memcmp(pictures[i].pixels, pixels, (size_t)sw * sh * sizeof(uint32_t)) == 0) {
+            free(pixels);
+            cell->picture = i;
+            return true;
+        }
+    }
+    pictures[pictureCount] = (Picture){0, 0, sw, sh, pixels};
+    cell->picture = pictureCount++;
+    return true;
+}
+
+static Table *table_named(const char *name, bool grid) {
+    for (int i = 0; i < tableCount; i++) {
+        if (strcmp(tables[i].name, name) == 0) return tables[i].grid || grid ? NULL : &tables[i]; // clips and strips append, grids stand alone
+    }
+    if (tableCount == ATLAS_MAX_TABLES) return NULL;
+    Table *table = &tables[tableCount++];
+    snprintf(table->name, sizeof(table->name), "%s", name);
+    table->first = cellCount;
+    table->grid = grid;
+    return table;
+}
+
+static bool read_manifest(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "%s: cannot read\n", path);
+        return false;
+    }
+
+    char line[256], kind[16], name[32];
+    int lineNo = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        lineNo++;
+        line[strcspn(line, "#\r\n")] = '\0';
+        int x, y, w, h, a = 1, b = 1;
+        int fields = sscanf(line, " %15s %31s %d %d %d %d %d %d", kind, name, &x, &y, &w, &h, &a, &b);
+        if (fields <= 0) continue;
+
+        // Cells of one table must be contiguous: a table is never reopened after another starts
+        bool grid = strcmp(kind, "grid") == 0;
+        Table *table = fields >= 6 ? table_named(name, grid) : NULL;
+        if (table && table != &tables[tableCount - 1]) table = NULL;
+        if (!table || (strcmp(kind, "clip") == 0 && fields != 6) || (strcmp(kind, "strip") == 0 && fields != 7) ||
+            (grid && fields != 8) || a < 1 || b < 1 || (!grid && strcmp(kind, "clip") != 0 && strcmp(kind, "strip") != 0)) {
+            fprintf(stderr, "%s:%d: bad line\n", path, lineNo);
+            ok = false;
+            break;
+        }
+        if (grid) {
+            table->cols = a;
+            table->rows = b;
+            table->sheet = (SDL_Rect){x, y, w, h};
+        } else {
+            b = 1;
+        }
+
+        for (int row = 0; ok && row < b; row++) {
+            for (int col = 0; ok && col < a; col++) ok = add_cell(x + col * w, y + row * h, w, h);
+        }
+        if (!ok) fprintf(stderr, "%s:%d: cell outside the sheet or too many cells\n", path, lineNo);
+        table->count = cellCount - table->first;
+    }
+    fclose(file);
+    return ok;
+}
+
+static int by_height(const void *a, const void *b) {
+    const Picture *pa = *(Picture *const *)a, *pb = *(Picture *const *)b;
+    if (pa->h != pb->h) return pb->h - pa->h;
+    return pb->w - pa->w;
+}
+
+// Shelves of the tallest pictures first; returns the height used at this width.
+static int shelf_pack(Picture **order, int width, bool place) {
+    int x = 0, y = 0, shelf = 0;
+    for (int i = 0; i < pictureCount; i++) {
+        Picture *p = order[i];
+        if (p->w > width) return ATLAS_MAX_SIDE + 1;
+        if (x + p->w > width) {
+            y += shelf;
+            x = shelf = 0;
+        }
+        if (place) {
+            p->x = x;
+            p->y = y;
+        }
+        x += p->w;
+        if (p->h > shelf) shelf = p->h;
+    }
+    return y + shelf;
+}
+
+// Tries every width in steps of the smallest cell: the smallest square bound wins, then the least area.
+static void pack(int *width, int *height) {
+    static Picture *order[ATLAS_MAX_CELLS];
+    int step = ATLAS_MAX_SIDE;
+    for (int i = 0; i < pictureCount; i++) {
+        order[i] = &pictures[i];
+        if (pictures[i].w < step) step = pictures[i].w;
+    }
+    qsort(order, pictureCount, sizeof(Picture *), by_height);
+
+    int bestSide = ATLAS_MAX_SIDE + 1;
+    long bestArea = 0;
+    for (int w = step; w <= ATLAS_MAX_SIDE; w += step) {
+        int h = shelf_pack(order, w, false);
+        int side = w > h ? w : h;
+        long area = (long)w * h;
+        if (side < bestSide || (side == bestSide && area < bestArea)) {
+            bestSide = side;
+            bestArea = area;
+            *width = w;
+            *height = h;
+        }
+    }
+    shelf_pack(order, *width, true);
+}
+
+static bool write_image(const char *path, int width, int height) {
+    SDL_Surface *atlas = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlas) return false;
+    memset(atlas->pixels, 0, (size_t)atlas->pitch * height);
+    for (int i = 0; i < pictureCount; i++) {
+        const Picture *p = &pictures[i];
+        for (int py = 0; py < p->h; py++) {
+            memcpy((uint8_t *)atlas->pixels + (size_t)(p->y + py) * atlas->pitch + (size_t)p->x * 4,
+                   p->pixels + (size_t)py * p->w, (size_t)p->w * 4);
+        }
+    }
+    bool ok = IMG_SavePNG(atlas, path) == 0;
+    SDL_FreeSurface(atlas);
+    return ok;
+}
+
+static void write_rect(FILE *file, int cell) {
+    const Picture *p = cells[cell].picture >= 0 ? &pictures[cells[cell].picture] : NULL;
+    if (p) fprintf(file, "{%d, %d, %d, %d}", p->x, p->y, p->w, p->h);
+    else fprintf(file, "{0, 0, 0, 0}");
+}
+
+static bool write_header(const char *path, const char *imageName, int width, int height) {
+    FILE *file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "// Generated by bin/atlas from tools/atlas.txt, do not edit.\n");
+    fprintf(file, "#ifndef PACMAN_ATLAS_H\n#define PACMAN_ATLAS_H\n\n");
+    fprintf(file, "#define ATLAS_IMAGE \"%s\"\n", imageName);
+    fprintf(file, "#define ATLAS_WIDTH %d\n#define ATLAS_HEIGHT %d\n", width, height);
+    fprintf(file, "#define ATLAS_SCALE %d // atlas pixels per sprites.png pixel\n", scale);
+    for (int t = 0; t < tableCount; t++) {
+        const Table *table = &tables[t];
+        fprintf(file, "\n");
+        if (!table->grid) {
+            fprintf(file, "const SDL_Rect %s[%d] = {\n", table->name, table->count);
+            for (int i = 0; i < table->count; i++) {
+                fprintf(file, "  ");
+                write_rect(file, table->first + i);
+                fprintf(file, ",\n");
+            }
+            fprintf(file, "};\n");
+            continue;
+        }
+
+        // Where the grid was cut from, to find a cell by its sheet position
+        fprintf(file, "const SDL_Rect %sSheet = {%d, %d, %d, %d};\n", table->name,
+                table->sheet.x, table->sheet.y, table->sheet.w, table->sheet.h);
+        fprintf(file, "const SDL_Rect %s[%d][%d] = {\n", table->name, table->rows, table->cols);
+        for (int row = 0; row < table->rows; row++) {
+            fprintf(file, "  {");
+            for (int col = 0; col < table->cols; col++) {
+                write_rect(file, table->first + row * table->cols + col);
+                fprintf(file, col + 1 < table->cols ? ", " : "");
+            }
+            fprintf(file, "},\n");
+        }
+        fprintf(file, "};\n");
+    }
+    fprintf(file, "\n#endif\n");
+    return fclose(file) == 0;
+}
+
+// The name the game loads it by: the path under assets/ when it is there.
+static const char *image_name(const char *path) {
+    const char *name = strstr(path, "assets/");
+    return name ? name + strlen("assets/") : path;
+}
+
+int main(int argc, char *argv[]) {
+    int arg = 1;
+    if (argc > 2 && strcmp(argv[1], "-s") == 0) {
+        scale = atoi(argv[2]);
+        arg = 3;
+    }
+    if (argc - arg != 4 || scale < 1 || scale > 8) {
+        fprintf(stderr, "usage: %s [-s 1..8] atlas.txt sprites.png atlas.png atlas.h\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *manifest = argv[arg], *sheetPath = argv[arg+1], *imagePath = argv[arg+2], *headerPath = argv[arg+3];
+
+    SDL_SetMainReady();
+    if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) == 0) {
+        fprintf(stderr, "IMG_Init failed: %s\n", IMG_GetError());
+        return EXIT_FAILURE;
+    }
+    SDL_Surface *loaded = IMG_Load(sheetPath);
+    sheet = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0) : NULL;
+    SDL_FreeSurface(loaded);
+    if (!sheet) {
+        fprintf(stderr, "%s: %s\n", sheetPath, SDL_GetError());
+        IMG_Quit();
+        return EXIT_FAILURE;
+    }
+
+    int width = 0, height = 0;
+    bool ok = read_manifest(manifest);
+    if (ok && pictureCount == 0) {
+        fprintf(stderr, "%s: no cells\n", manifest);
+        ok = false;
+    }
+    if (ok) {
+        pack(&width, &height);
+        ok = width > 0;
+        if (!ok) fprintf(stderr, "%s: does not fit in %dx%d\n", manifest, ATLAS_MAX_SIDE, ATLAS_MAX_SIDE);
+    }
+    if (ok && !write_image(imagePath, width, height)) {
+        fprintf(stderr, "%s: %s\n", imagePath, SDL_GetError());
+        ok = false;
+    }
+    // The header last: make sees it up to date only when the image is too
+    if (ok && !write_header(headerPath, image_name(imagePath), width, height)) {
+        fprintf(stderr, "%s: not written\n", headerPath);
+        ok = false;
+    }
+    if (ok) {
+        printf("%s: %d cells, %d distinct, %dx%d (sheet %dx%d)\n", imagePath, cellCount, pictureCount,
+               width, height, sheet->w, sheet->h);
+    }
+
+    for (int i = 0; i < pictureCount; i++) free(pictures[i].pixels);
+    SDL_FreeSurface(sheet);
+    IMG_Quit();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,55 @@
+/* Offline map compiler: levels/NAME.txt in, levels/NAME.lvl out.
+ * Does all the maze analysis at build time so the game only reads the result. */
+
+#include "level.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static char *read_text(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    char *text = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if (size >= 0 && fseek(file, 0, SEEK_SET) == 0 && (text = malloc((size_t)size + 1))) {
+        if (fread(text, 1, (size_t)size, file) == (size_t)size) {
+            text[size] = '\0';
+        } else {
+            free(text);
+            text = NULL;
+        }
+    }
+    fclose(file);
+    return text;
+}
+
+int main(int argc, char *argv[]) {
+    static Level level;
+    char error[160];
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s map.txt level.lvl\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    char *text = read_text(argv[1]);
+    if (!text) {
+        fprintf(stderr, "%s: cannot read\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    bool ok = level_compile(&level, text, error, sizeof(error));
+    free(text);
+    if (!ok) {
+        fprintf(stderr, "%s: %s\n", argv[1], error);
+        return EXIT_FAILURE;
+    }
+    if (!level_save(&level, argv[2])) {
+        fprintf(stderr, "%s: cannot write\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%s: %u dots, %zu bytes\n", argv[2], level.maze.dotCount, sizeof(Level));
+    return EXIT_SUCCESS;
+}
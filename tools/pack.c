@@ -0,0 +1,242 @@
+/* Asset packer: every file under assets/ in, assets.pak out.
+ * PNGs are decoded to RGBA32 and short WAVs converted to the mixer's output
+ * format here, so the game maps the archive and uploads without decoding
+ * anything. WAVs over ARCHIVE_STREAM_BYTES are streamed and stay as they are,
+ * and so do files SDL_LoadWAV() cannot read. */
+
+#define SDL_MAIN_HANDLED
+#include "archive.h"
+#if defined(_WIN32) || defined(__APPLE__)
+#include <SDL_image.h>
+#else
+#include <SDL2/SDL_image.h>
+#endif
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PACK_MAX_ENTRIES 64
+
+typedef struct {
+  ArchiveEntry entry;
+  void *data;
+} Packed;
+
+static Packed packed[PACK_MAX_ENTRIES];
+static uint32_t packedCount;
+
+static bool has_suffix(const char *name, const char *suffix) {
+    size_t len = strlen(name), suffixLen = strlen(suffix);
+    return len >= suffixLen && SDL_strcasecmp(name + len - suffixLen, suffix) == 0;
+}
+
+static void *read_file(const char *path, uint32_t *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    void *data = NULL;
+    long length = -1;
+    if (fseek(file, 0, SEEK_END) == 0) length = ftell(file);
+    if (length >= 0 && fseek(file, 0, SEEK_SET) == 0 && (data = malloc(length ? (size_t)length : 1))) {
+        if (fread(data, 1, (size_t)length, file) != (size_t)length) {
+            free(data);
+            data = NULL;
+        }
+        *size = (uint32_t)length;
+    }
+    fclose(file);
+    return data;
+}
+
+static void *decode_image(const char *path, ArchiveEntry *entry) {
+    SDL_Surface *loaded = IMG_Load(path);
+    SDL_Surface *rgba = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0) : NULL;
+    SDL_FreeSurface(loaded);
+    if (!rgba) return NULL;
+
+    size_t rowBytes = (size_t)rgba->w * 4;
+    uint8_t *pixels = malloc(rowBytes * rgba->h);
+    if (pixels) {
+        for (int y = 0; y < rgba->h; y++) memcpy(pixels + y * rowBytes, (uint8_t *)rgba->pixels + y * rgba->pitch, rowBytes);
+        entry->width = (uint32_t)rgba->w;
+        entry->height = (uint32_t)rgba->h;
+        entry->size = (uint32_t)(rowBytes * rgba->h);
+    }
+    SDL_FreeSurface(rgba);
+    return pixels;
+}
+
+// What Mix_LoadWAV() does at every startup, once.
+static void *convert_sound(const char *path, ArchiveEntry *entry) {
+    SDL_AudioSpec spec;
+    Uint8 *wav;
+    Uint32 wavLen;
+    if (!SDL_LoadWAV(path, &spec, &wav, &wavLen)) return NULL;
+
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq,
+                          ARCHIVE_AUDIO_FORMAT, ARCHIVE_AUDIO_CHANNELS, ARCHIVE_AUDIO_FREQ) < 0) {
+        SDL_FreeWAV(wav);
+        return NULL;
+    }
+    cvt.len = (int)wavLen;
+    cvt.buf = malloc((size_t)wavLen * cvt.len_mult);
+    if (cvt.buf) {
+        memcpy(cvt.buf, wav, wavLen);
+        if (SDL_ConvertAudio(&cvt) == 0) {
+            entry->size = (uint32_t)cvt.len_cvt;
+        } else {
+            free(cvt.buf);
+            cvt.buf = NULL;
+        }
+    }
+    SDL_FreeWAV(wav);
+    return cvt.buf;
+}
+
+// Long sounds are kept as WAV files: the game streams them as music.
+static bool streamed(const char *path) {
+    FILE *file = fopen(path, "rb");
+    long length = -1;
+    if (file && fseek(file, 0, SEEK_END) == 0) length = ftell(file);
+    if (file) fclose(file);
+    return length > ARCHIVE_STREAM_BYTES;
+}
+
+static bool pack_file(const char *path, const char *name) {
+    if (packedCount == PACK_MAX_ENTRIES) {
+        fprintf(stderr, "%s: more than %d assets\n", path, PACK_MAX_ENTRIES);
+        return false;
+    }
+    if (strlen(name) >= ARCHIVE_NAME_MAX) {
+        fprintf(stderr, "%s: name longer than %d\n", path, ARCHIVE_NAME_MAX - 1);
+        return false;
+    }
+
+    Packed *p = &packed[packedCount];
+    memset(&p->entry, 0, sizeof(ArchiveEntry)); // padding too, so the same assets always pack the same bytes
+    strcpy(p->entry.name, name);
+    if (has_suffix(name, ".png")) {
+        p->entry.kind = ARCHIVE_IMAGE;
+        p->data = decode_image(path, &p->entry);
+    } else if (has_suffix(name, ".wav") && !streamed(path)) {
+        p->entry.kind = ARCHIVE_SOUND;
+        p->data = convert_sound(path, &p->entry);
+        if (!p->data) {
+            // Not a WAV SDL can read (pacman_move.wav is an MP3): the mixer decodes the bytes at load
+            printf("%s: %s, kept as file bytes\n", path, SDL_GetError());
+            p->entry.kind = ARCHIVE_BLOB;
+            p->data = read_file(path, &p->entry.size);
+        }
+    } else {
+        p->entry.kind = ARCHIVE_BLOB;
+        p->data = read_file(path, &p->entry.size);
+    }
+    if (!p->data) {
+        fprintf(stderr, "%s: %s\n", path, SDL_GetError());
+        return false;
+    }
+    packedCount++;
+    return true;
+}
+
+// Depth first; names are relative to the assets root with '/' separators.
+static bool pack_dir(const char *dirPath, const char *prefix) {
+    DIR *dir = opendir(dirPath);
+    if (!dir) {
+        fprintf(stderr, "%s: cannot open\n", dirPath);
+        return false;
+    }
+
+    bool ok = true;
+    struct dirent *item;
+    while (ok && (item = readdir(dir))) {
+        if (item->d_name[0] == '.') continue;
+
+        char path[1024], name[1024];
+        snprintf(path, sizeof(path), "%s/%s", dirPath, item->d_name);
+        snprintf(name, sizeof(name), "%s%s", prefix, item->d_name);
+
+        DIR *sub = opendir(path);
+        if (sub) {
+            closedir(sub);
+            strcat(name, "/");
+            ok = pack_dir(path, name);
+        } else {
+            ok = pack_file(path, name);
+        }
+    }
+    closedir(dir);
+    return ok;
+}
+
+static int by_name(const void *a, const void *b) {
+    return strcmp(((const Packed *)a)->entry.name, ((const Packed *)b)->entry.name);
+}
+
+static uint32_t align_up(uint32_t offset) {
+    return (offset + ARCHIVE_ALIGN - 1) & ~(uint32_t)(ARCHIVE_ALIGN - 1);
+}
+
+static bool write_archive(const char *path) {
+    static const uint8_t zeros[ARCHIVE_ALIGN];
+    ArchiveHeader header = {ARCHIVE_MAGIC, ARCHIVE_VERSION, packedCount, 0};
+
+    // readdir() order is up to the filesystem
+    qsort(packed, packedCount, sizeof(Packed), by_name);
+
+    uint32_t offset = (uint32_t)(sizeof(ArchiveHeader) + packedCount * sizeof(ArchiveEntry));
+    for (uint32_t i = 0; i < packedCount; i++) {
+        packed[i].entry.offset = offset = align_up(offset);
+        offset += packed[i].entry.size;
+    }
+    header.bytes = offset;
+
+    FILE *file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (uint32_t i = 0; ok && i < packedCount; i++) ok = fwrite(&packed[i].entry, sizeof(ArchiveEntry), 1, file) == 1;
+
+    uint32_t at = (uint32_t)(sizeof(ArchiveHeader) + packedCount * sizeof(ArchiveEntry));
+    for (uint32_t i = 0; ok && i < packedCount; i++) {
+        const ArchiveEntry *entry = &packed[i].entry;
+        ok = fwrite(zeros, 1, entry->offset - at, file) == entry->offset - at &&
+             fwrite(packed[i].data, 1, entry->size, file) == entry->size;
+        at = entry->offset + entry->size;
+    }
+    return fclose(file) == 0 && ok;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s assets/ assets.pak\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    SDL_SetMainReady();
+    if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) == 0) {
+        fprintf(stderr, "IMG_Init failed: %s\n", IMG_GetError());
+        return EXIT_FAILURE;
+    }
+
+    char root[1024];
+    snprintf(root, sizeof(root), "%s", argv[1]);
+    size_t len = strlen(root);
+    while (len > 1 && (root[len-1] == '/' || root[len-1] == '\\')) root[--len] = '\0';
+
+    bool ok = pack_dir(root, "") && write_archive(argv[2]);
+    IMG_Quit();
+    if (!ok) {
+        fprintf(stderr, "%s: not written\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    uint32_t bytes = 0;
+    for (uint32_t i = 0; i < packedCount; i++) {
+        bytes = packed[i].entry.offset + packed[i].entry.size;
+        free(packed[i].data);
+    }
+    printf("%s: %u assets, %u bytes\n", argv[2], packedCount, bytes);
+    return EXIT_SUCCESS;
+}